@@ -4,6 +4,7 @@
 // CURSO: Programación 3
 // DESCRIPCIÓN: Sistema para gestionar miembros, clases y asistencias
 // ESTRUCTURA: Simulación de archivos separados (.h, .cpp) en un solo fichero
+// COMPILAR: g++ -std=c++17 -O2 -pthread progra3.cpp -o gimnasio
 // =================================================================================
 
 #include <iostream>
@@ -13,512 +14,7014 @@
 #include <fstream>
 #include <sstream>
 #include <limits>
+#include <memory>
+#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <charconv>
+#include <ctime>
+#include <iterator>
+#include <cstdint>
+#include <cctype>
+#include <numeric>
+#include <memory_resource>
+#include <new>
+#include <cstdlib>
+#include <thread>
+#include <condition_variable>
+#include <future>
+#include <deque>
+#include <string_view>
+#include <map>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// =================================================================================
+// ARCHIVO: Memoria.h
+// RESPONSABILIDAD: Conteo global de asignaciones de memoria dinamica
+// =================================================================================
+
+// Contar obliga a reemplazar los operadores globales new/delete, y eso lo paga
+// cada asignacion de cada hilo. Por eso el conteo solo se compila en las
+// mediciones, con -DGIMNASIO_CONTAR_ASIGNACIONES; sin esa bandera los totales
+// quedan en cero y se muestran como "sin conteo de asignaciones".
+#ifdef GIMNASIO_CONTAR_ASIGNACIONES
+constexpr bool CONTEO_ASIGNACIONES = true;
+#else
+constexpr bool CONTEO_ASIGNACIONES = false;
+#endif
+
+// Totales acumulados desde el inicio del programa; para medir una operacion se
+// toma una foto antes y se resta despues.
+struct EstadisticasMemoria {
+    std::uint64_t asignaciones;
+    std::uint64_t bytes;
+
+    EstadisticasMemoria operator-(const EstadisticasMemoria& antes) const {
+        return {asignaciones - antes.asignaciones, bytes - antes.bytes};
+    }
+};
+
+EstadisticasMemoria estadisticasMemoria();
+
+// "N asignaciones, X.X MB" (o "sin conteo de asignaciones")
+std::ostream& operator<<(std::ostream& os, const EstadisticasMemoria& e);
+
+// =================================================================================
+// ARCHIVO: RegistroIndexado.h
+// RESPONSABILIDAD: Almacena elementos contiguos con un indice hash clave -> slot
+// =================================================================================
+
+// Un handle es la posicion (slot) del elemento dentro del registro. A diferencia
+// de un puntero crudo, sigue siendo valido cuando el vector crece y se realoja.
+using Handle = std::uint32_t;
+constexpr Handle HANDLE_INVALIDO = std::numeric_limits<Handle>::max();
+
+// Los nodos del indice salen de una arena monotona propia: una carga completa
+// cuesta unos pocos bloques grandes en vez de una asignacion por clave. Las
+// claves nunca se borran individualmente, asi que la arena solo se libera
+// entera en clear().
+template <typename Clave, typename T>
+class RegistroIndexado {
+private:
+    using Indice = std::pmr::unordered_map<Clave, Handle>;
+
+    std::vector<T> elementos;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena =
+        std::make_unique<std::pmr::monotonic_buffer_resource>();
+    Indice indice{arena.get()};
+
+public:
+    Handle buscar(const Clave& clave) const {
+        auto it = indice.find(clave);
+        return it != indice.end() ? it->second : HANDLE_INVALIDO;
+    }
+
+    // Inserta un elemento nuevo; devuelve HANDLE_INVALIDO si la clave ya existe
+    template <typename... Args>
+    Handle insertar(const Clave& clave, Args&&... args) {
+        Handle h = static_cast<Handle>(elementos.size());
+        if (!indice.emplace(clave, h).second) {
+            return HANDLE_INVALIDO;
+        }
+        elementos.emplace_back(std::forward<Args>(args)...);
+        return h;
+    }
+
+    T& obtener(Handle h) { return elementos[h]; }
+    const T& obtener(Handle h) const { return elementos[h]; }
+
+    void reserve(std::size_t n) {
+        elementos.reserve(n);
+        indice.reserve(n);
+    }
+
+    void clear() {
+        elementos.clear();
+        {
+            Indice vacio(arena.get());
+            indice.swap(vacio);
+        }  // los nodos viejos se destruyen antes de devolver la arena
+        arena->release();
+    }
+
+    std::size_t size() const { return elementos.size(); }
+    bool empty() const { return elementos.empty(); }
+
+    typename std::vector<T>::iterator begin() { return elementos.begin(); }
+    typename std::vector<T>::iterator end() { return elementos.end(); }
+    typename std::vector<T>::const_iterator begin() const { return elementos.begin(); }
+    typename std::vector<T>::const_iterator end() const { return elementos.end(); }
+};
+
+// =================================================================================
+// ARCHIVO: ConjuntoIds.h
+// RESPONSABILIDAD: Conjunto de IDs enteros con insercion/busqueda/borrado O(1)
+// =================================================================================
+
+// Direccionamiento abierto con sondeo lineal sobre una tabla de potencia de 2.
+// El borrado desplaza hacia atras los elementos del mismo cluster, asi no hacen
+// falta lapidas y la tabla no se degrada con muchas altas y bajas.
+class ConjuntoIds {
+private:
+    static constexpr std::int32_t VACIO = std::numeric_limits<std::int32_t>::min();
+    std::vector<std::int32_t> celdas;
+    std::size_t cantidad;
+
+    std::size_t posicionIdeal(std::int32_t id) const {
+        // Hash de Fibonacci: dispersa bien IDs consecutivos
+        std::uint64_t h = static_cast<std::uint32_t>(id) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h >> 32) & (celdas.size() - 1);
+    }
+
+    std::size_t ubicar(std::int32_t id) const {
+        std::size_t mascara = celdas.size() - 1;
+        std::size_t i = posicionIdeal(id);
+        while (celdas[i] != VACIO && celdas[i] != id) i = (i + 1) & mascara;
+        return i;
+    }
+
+    void redimensionar(std::size_t capacidad) {
+        std::vector<std::int32_t> anteriores(capacidad, VACIO);
+        anteriores.swap(celdas);
+        for (std::int32_t id : anteriores) {
+            if (id != VACIO) celdas[ubicar(id)] = id;
+        }
+    }
+
+    void crecer() { redimensionar(celdas.empty() ? 8 : celdas.size() * 2); }
+
+public:
+    ConjuntoIds() : cantidad(0) {}
+
+    // Deja lugar para n ids sin volver a crecer (una sola asignacion)
+    void reservar(std::size_t n) {
+        std::size_t capacidad = celdas.empty() ? 8 : celdas.size();
+        while (n * 2 > capacidad) capacidad *= 2;
+        if (capacidad != celdas.size()) redimensionar(capacidad);
+    }
+
+    bool contiene(std::int32_t id) const {
+        return id != VACIO && !celdas.empty() && celdas[ubicar(id)] == id;
+    }
+
+    bool insertar(std::int32_t id) {
+        if (id == VACIO) return false;
+        if ((cantidad + 1) * 2 > celdas.size()) crecer();  // factor de carga <= 0.5
+        std::size_t i = ubicar(id);
+        if (celdas[i] == id) return false;
+        celdas[i] = id;
+        cantidad++;
+        return true;
+    }
+
+    bool eliminar(std::int32_t id) {
+        if (!contiene(id)) return false;
+        std::size_t mascara = celdas.size() - 1;
+        std::size_t hueco = ubicar(id);
+        std::size_t j = hueco;
+        while (true) {
+            j = (j + 1) & mascara;
+            if (celdas[j] == VACIO) break;
+            std::size_t ideal = posicionIdeal(celdas[j]);
+            // Se mueve al hueco si su posicion ideal no cae entre hueco y j
+            if (((j - ideal) & mascara) >= ((j - hueco) & mascara)) {
+                celdas[hueco] = celdas[j];
+                hueco = j;
+            }
+        }
+        celdas[hueco] = VACIO;
+        cantidad--;
+        return true;
+    }
+
+    template <typename Funcion>
+    void paraCada(Funcion&& funcion) const {
+        for (std::int32_t id : celdas) {
+            if (id != VACIO) funcion(id);
+        }
+    }
+
+    std::size_t size() const { return cantidad; }
+    bool empty() const { return cantidad == 0; }
+};
+
+// =================================================================================
+// ARCHIVO: GrafoCSR.h
+// RESPONSABILIDAD: Grafo compacto en formato CSR (compressed sparse row)
+// =================================================================================
+
+// Los vecinos del nodo i son vecinos[filas[i] .. filas[i+1]). Son dos arreglos
+// contiguos sin importar cuantas aristas haya: se escriben y se leen de una vez.
+struct GrafoCSR {
+    std::vector<std::uint32_t> filas{0};
+    std::vector<std::uint32_t> vecinos;
+
+    std::size_t nodos() const { return filas.size() - 1; }
+    std::size_t aristas() const { return vecinos.size(); }
+    std::uint32_t grado(std::size_t i) const { return filas[i + 1] - filas[i]; }
+    const std::uint32_t* inicio(std::size_t i) const { return vecinos.data() + filas[i]; }
+    const std::uint32_t* fin(std::size_t i) const { return vecinos.data() + filas[i + 1]; }
+
+    // Cierra la fila del nodo actual (los vecinos se agregan antes con push_back)
+    void cerrarFila() { filas.push_back(static_cast<std::uint32_t>(vecinos.size())); }
+
+    // filas no decrecientes y dentro de 'vecinos' (para datos leidos de disco)
+    bool valido() const {
+        if (filas.empty() || filas.front() != 0 || filas.back() != vecinos.size()) return false;
+        return std::is_sorted(filas.begin(), filas.end());
+    }
+
+    // Arma el grafo desde una lista de aristas (origen, destino) en cualquier
+    // orden, por conteo: O(V + E). Se ignoran origenes fuera de rango.
+    static GrafoCSR desdeAristas(std::size_t nodos,
+                                 const std::vector<std::pair<std::uint32_t, std::uint32_t>>& aristas) {
+        GrafoCSR g;
+        g.filas.assign(nodos + 1, 0);
+        for (const auto& a : aristas) {
+            if (a.first < nodos) g.filas[a.first + 1]++;
+        }
+        for (std::size_t i = 0; i < nodos; i++) g.filas[i + 1] += g.filas[i];
+        g.vecinos.resize(g.filas.back());
+        std::vector<std::uint32_t> siguiente(g.filas.begin(), g.filas.end() - 1);
+        for (const auto& a : aristas) {
+            if (a.first < nodos) g.vecinos[siguiente[a.first]++] = a.second;
+        }
+        return g;
+    }
+
+    // Grafo inverso: la arista i->j pasa a ser j->i
+    GrafoCSR transpuesto(std::size_t nodosDestino) const {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> invertidas;
+        invertidas.reserve(vecinos.size());
+        for (std::size_t i = 0; i < nodos(); i++) {
+            for (const std::uint32_t* v = inicio(i); v != fin(i); ++v) {
+                invertidas.emplace_back(*v, static_cast<std::uint32_t>(i));
+            }
+        }
+        return desdeAristas(nodosDestino, invertidas);
+    }
+};
+
+// =================================================================================
+// ARCHIVO: Exportacion.h
+// RESPONSABILIDAD: Listados filtrables y paginados en texto, CSV o JSON
+// =================================================================================
+
+enum class FormatoExportacion { Texto, Csv, Json };
+
+// Escribe a un descriptor a traves de un buffer grande que se reutiliza entre
+// paginas y exportaciones: una llamada al sistema por MiB, no por registro.
+class SalidaBuffer {
+public:
+    static constexpr std::size_t TAM_BUFFER = 1 << 20;
+
+private:
+    int fd;
+    bool propio;  // el descriptor se abrio aca y se cierra al destruir
+    bool correcto;
+    std::vector<char> buffer;
+    std::size_t usado;
+
+    void reservar(std::size_t n) {
+        if (usado + n > buffer.size()) vaciar();
+    }
+
+public:
+    explicit SalidaBuffer(int fd = STDOUT_FILENO, std::size_t capacidad = TAM_BUFFER);
+    ~SalidaBuffer();
+    SalidaBuffer(const SalidaBuffer&) = delete;
+    SalidaBuffer& operator=(const SalidaBuffer&) = delete;
+
+    bool abrir(const std::string& ruta);  // crea o trunca el archivo
+    void vaciar();
+    bool ok() const { return correcto; }
+
+    void escribir(const char* datos, std::size_t largo);
+    SalidaBuffer& operator<<(const std::string& texto) {
+        escribir(texto.data(), texto.size());
+        return *this;
+    }
+    SalidaBuffer& operator<<(const char* texto) {
+        escribir(texto, std::strlen(texto));
+        return *this;
+    }
+    SalidaBuffer& operator<<(char c) {
+        reservar(1);
+        buffer[usado++] = c;
+        return *this;
+    }
+    SalidaBuffer& operator<<(std::int64_t valor) {
+        reservar(24);
+        auto r = std::to_chars(buffer.data() + usado, buffer.data() + buffer.size(), valor);
+        usado = static_cast<std::size_t>(r.ptr - buffer.data());
+        return *this;
+    }
+    SalidaBuffer& operator<<(int valor) { return *this << static_cast<std::int64_t>(valor); }
+    SalidaBuffer& operator<<(std::size_t valor) {
+        return *this << static_cast<std::int64_t>(valor);
+    }
+
+    // Campo CSV (RFC 4180): entre comillas solo si hace falta
+    void campoCsv(const std::string& texto);
+    // Cadena JSON con comillas y escapes
+    void cadenaJson(const std::string& texto);
+};
+
+// Valores negativos = sin filtro
+struct FiltroMiembros {
+    int tipoMembresia = -1;       // valor de TipoMembresia
+    int activo = -1;              // 1 activos, 0 inactivos
+    std::int32_t minAsistencias = 0;
+};
+
+struct FiltroClases {
+    std::string instructor;       // vacio = todos
+    bool soloConCupo = false;
+};
+
+// Configuracion del modo "--exportar" por linea de comandos
+struct ConfigExportacion {
+    bool clases = false;          // false = miembros
+    FormatoExportacion formato = FormatoExportacion::Csv;
+    FiltroMiembros filtroMiembros;
+    FiltroClases filtroClases;
+    Handle cursor = 0;
+    std::size_t limite = std::numeric_limits<std::size_t>::max();
+    std::string salida;           // vacio = stdout
+};
+
+// Lee "--exportar <miembros|clases> [--formato texto|csv|json] [--membresia T]
+// [--activos 0|1] [--min-asistencias N] [--instructor X] [--con-cupo] [--desde C]
+// [--limite N] [--salida archivo]"; false si algun argumento es invalido
+bool parsearConfigExportacion(int argc, char* argv[], ConfigExportacion& config);
+
+// =================================================================================
+// ARCHIVO: Horario.h
+// RESPONSABILIDAD: Horarios semanales estructurados e indices por franja horaria
+// =================================================================================
+
+// Codigo de clase internado: el slot de la clase en el registro del gimnasio.
+// Es estable y compacto, asi los miembros no guardan copias del codigo.
+using IdClase = Handle;
+
+constexpr int MINUTOS_DIA = 24 * 60;
+constexpr int MINUTOS_SEMANA = 7 * MINUTOS_DIA;
+
+// [inicio, fin) en minutos desde el lunes 00:00
+struct IntervaloSemanal {
+    int inicio;
+    int fin;
+
+    bool seSolapa(const IntervaloSemanal& otro) const {
+        return inicio < otro.fin && otro.inicio < fin;
+    }
+};
+
+// Interpreta "Lun 08:00-09:00", "Lun,Mie,Vie 18:00-19:00", "Lun-Vie 07:00-08:00"
+// o varios tramos separados por ';'. Un tramo que pasa la medianoche sigue en el
+// dia siguiente (y el domingo sigue en el lunes). Los intervalos quedan ordenados
+// y sin solapes. false si el texto no tiene ese formato (horario libre).
+bool parsearHorario(const std::string& texto, std::vector<IntervaloSemanal>& intervalos);
+
+// Clases que ocupan a un miembro, ordenadas por inicio. Como nunca se solapan,
+// tambien quedan ordenadas por fin y un conflicto se busca con busqueda binaria.
+class AgendaSemanal {
+private:
+    struct Entrada {
+        IntervaloSemanal intervalo;
+        IdClase clase;
+    };
+    std::vector<Entrada> entradas;
+
+public:
+    // Primera clase de la agenda que se solapa con alguno de los intervalos;
+    // HANDLE_INVALIDO si no hay conflicto
+    IdClase buscarConflicto(const std::vector<IntervaloSemanal>& intervalos) const {
+        for (const IntervaloSemanal& intervalo : intervalos) {
+            auto it = std::upper_bound(entradas.begin(), entradas.end(), intervalo.inicio,
+                                       [](int t, const Entrada& e) { return t < e.intervalo.fin; });
+            if (it != entradas.end() && it->intervalo.inicio < intervalo.fin) return it->clase;
+        }
+        return HANDLE_INVALIDO;
+    }
+
+    void agregar(IdClase clase, const std::vector<IntervaloSemanal>& intervalos) {
+        for (const IntervaloSemanal& intervalo : intervalos) {
+            auto it = std::lower_bound(entradas.begin(), entradas.end(), intervalo.inicio,
+                                       [](const Entrada& e, int t) { return e.intervalo.inicio < t; });
+            entradas.insert(it, {intervalo, clase});
+        }
+    }
+
+    void quitar(IdClase clase) {
+        entradas.erase(std::remove_if(entradas.begin(), entradas.end(),
+                                      [clase](const Entrada& e) { return e.clase == clase; }),
+                       entradas.end());
+    }
+
+    void reserve(std::size_t n) { entradas.reserve(n); }
+    void clear() { entradas.clear(); }
+};
+
+// Linea de tiempo de todas las clases en cubetas de una hora (168 por semana).
+// Cada intervalo se anota en cada cubeta que toca; una consulta recorre solo las
+// cubetas de la ventana y reporta cada intervalo una vez, en la cubeta donde
+// empieza su parte dentro de la ventana.
+class LineaTiempoSemanal {
+public:
+    static constexpr int MINUTOS_CUBETA = 60;
+    static constexpr int NUM_CUBETAS = MINUTOS_SEMANA / MINUTOS_CUBETA;
+
+private:
+    struct Entrada {
+        IntervaloSemanal intervalo;
+        IdClase clase;
+    };
+    std::array<std::vector<Entrada>, NUM_CUBETAS> cubetas;
+
+public:
+    void agregar(IdClase clase, const std::vector<IntervaloSemanal>& intervalos) {
+        for (const IntervaloSemanal& intervalo : intervalos) {
+            for (int c = intervalo.inicio / MINUTOS_CUBETA;
+                 c * MINUTOS_CUBETA < intervalo.fin; c++) {
+                cubetas[c].push_back({intervalo, clase});
+            }
+        }
+    }
+
+    // funcion(clase, intervalo) para cada intervalo que se solapa con [desde, hasta)
+    template <typename Funcion>
+    void paraCadaEntre(const IntervaloSemanal& ventana, Funcion&& funcion) const {
+        int desde = std::max(ventana.inicio, 0);
+        int hasta = std::min(ventana.fin, MINUTOS_SEMANA);
+        for (int c = desde / MINUTOS_CUBETA; c * MINUTOS_CUBETA < hasta; c++) {
+            for (const Entrada& e : cubetas[c]) {
+                if (!e.intervalo.seSolapa(ventana)) continue;
+                if (std::max(e.intervalo.inicio, desde) / MINUTOS_CUBETA != c) continue;
+                funcion(e.clase, e.intervalo);
+            }
+        }
+    }
+
+    void clear() {
+        for (auto& cubeta : cubetas) cubeta.clear();
+    }
+};
 
 // =================================================================================
 // ARCHIVO: ClaseGym.h
 // RESPONSABILIDAD: Representa una clase/entrenamiento del gimnasio
 // =================================================================================
 
-class ClaseGym {
-private:
-    std::string nombreClase;
-    std::string instructor;
-    std::string horario;
-    std::string codigoClase;
-    int capacidadMaxima;
-    int inscritos;
-    std::vector<int> idsMiembrosInscritos;
+// Lista de espera de una clase: monticulo por (prioridad desc, orden de llegada asc).
+// Retirar a alguien es O(1) amortizado: su entrada queda en el monticulo y se
+// descarta al llegar a la cima o al compactar. 'vigentes' guarda el orden de la
+// entrada valida de cada miembro, asi una entrada vieja de alguien que volvio a
+// anotarse no cuenta.
+class ListaEspera {
+private:
+    struct Entrada {
+        int prioridad;
+        std::uint64_t orden;
+        int idMiembro;
+    };
+    struct MenorPrioridad {
+        bool operator()(const Entrada& a, const Entrada& b) const {
+            return a.prioridad != b.prioridad ? a.prioridad < b.prioridad : a.orden > b.orden;
+        }
+    };
+
+    std::vector<Entrada> monticulo;
+    std::unordered_map<int, std::uint64_t> vigentes;
+    std::uint64_t siguienteOrden = 0;
+
+    bool esVigente(const Entrada& e) const {
+        auto it = vigentes.find(e.idMiembro);
+        return it != vigentes.end() && it->second == e.orden;
+    }
+
+    void descartarRetirados() {
+        while (!monticulo.empty() && !esVigente(monticulo.front())) {
+            std::pop_heap(monticulo.begin(), monticulo.end(), MenorPrioridad());
+            monticulo.pop_back();
+        }
+    }
+
+public:
+    // false si el miembro ya estaba en espera
+    bool agregar(int idMiembro, int prioridad) {
+        if (!vigentes.emplace(idMiembro, siguienteOrden).second) return false;
+        monticulo.push_back({prioridad, siguienteOrden++, idMiembro});
+        std::push_heap(monticulo.begin(), monticulo.end(), MenorPrioridad());
+        return true;
+    }
+
+    // Si las entradas retiradas pasan a ser mayoria se rehace el monticulo solo
+    // con las vigentes, asi su tamano queda acotado por 2 * size().
+    bool retirar(int idMiembro) {
+        if (vigentes.erase(idMiembro) == 0) return false;
+        if (monticulo.size() > 2 * vigentes.size()) {
+            monticulo.erase(std::remove_if(monticulo.begin(), monticulo.end(),
+                                           [this](const Entrada& e) { return !esVigente(e); }),
+                            monticulo.end());
+            std::make_heap(monticulo.begin(), monticulo.end(), MenorPrioridad());
+        }
+        return true;
+    }
+
+    // Vuelve a poner una entrada con su orden original (carga de snapshot)
+    bool restaurar(int idMiembro, int prioridad, std::uint64_t orden) {
+        if (!vigentes.emplace(idMiembro, orden).second) return false;
+        monticulo.push_back({prioridad, orden, idMiembro});
+        std::push_heap(monticulo.begin(), monticulo.end(), MenorPrioridad());
+        siguienteOrden = std::max(siguienteOrden, orden + 1);
+        return true;
+    }
+
+    // Recorre las entradas vigentes, sin orden: f(idMiembro, prioridad, orden)
+    template <typename F>
+    void paraCada(F&& f) const {
+        for (const Entrada& e : monticulo) {
+            if (esVigente(e)) f(e.idMiembro, e.prioridad, e.orden);
+        }
+    }
+
+    bool contiene(int idMiembro) const { return vigentes.count(idMiembro) > 0; }
+    bool empty() const { return vigentes.empty(); }
+    std::size_t size() const { return vigentes.size(); }
+
+    // Siguiente en ser promovido; -1 si la lista esta vacia
+    int primero() {
+        descartarRetirados();
+        return monticulo.empty() ? -1 : monticulo.front().idMiembro;
+    }
+};
+
+// Lo que se muestra de una clase, copiado bajo su franja: se formatea despues
+// de soltar los bloqueos.
+struct FilaClase {
+    std::string codigo;
+    std::string nombre;
+    std::string instructor;
+    std::string horario;
+    int inscritos;
+    int capacidad;
+    std::size_t enEspera;
+
+    void escribirInformacion(SalidaBuffer& salida) const;
+};
+
+class ClaseGym {
+private:
+    std::string nombreClase;
+    std::string instructor;
+    std::string horario;
+    std::vector<IntervaloSemanal> intervalos;  // vacio si el horario es texto libre
+    std::string codigoClase;
+    int capacidadMaxima;
+    ConjuntoIds idsMiembrosInscritos;
+    ListaEspera listaEspera;
+
+public:
+    ClaseGym(const std::string& nombre, const std::string& instructor,
+             const std::string& horario, const std::string& codigo, int capacidad);
+
+    // Getters
+    const std::string& getNombre() const { return nombreClase; }
+    const std::string& getInstructor() const { return instructor; }
+    const std::string& getHorario() const { return horario; }
+    const std::vector<IntervaloSemanal>& getIntervalos() const { return intervalos; }
+    bool tieneHorarioEstructurado() const { return !intervalos.empty(); }
+    const std::string& getCodigo() const { return codigoClase; }
+    int getCapacidadMaxima() const { return capacidadMaxima; }
+    int getInscritos() const { return static_cast<int>(idsMiembrosInscritos.size()); }
+    bool tieneCupo() const { return getInscritos() < capacidadMaxima; }
+    const ConjuntoIds& getIdsInscritos() const { return idsMiembrosInscritos; }
+    void reservarInscritos(std::size_t n) { idsMiembrosInscritos.reservar(n); }
+    ListaEspera& getListaEspera() { return listaEspera; }
+    const ListaEspera& getListaEspera() const { return listaEspera; }
+
+    // Métodos de operación
+    bool inscribirMiembro(int idMiembro);
+    bool cancelarInscripcion(int idMiembro);
+    bool estaMiembroInscrito(int idMiembro) const;
+    FilaClase capturarFila() const;
+    void escribirInformacion(SalidaBuffer& salida) const;
+    void mostrarInformacion() const;
+};
+
+// =================================================================================
+// ARCHIVO: SerieTemporal.h
+// RESPONSABILIDAD: Historial de asistencias comprimido y conteos por hora
+// =================================================================================
+
+// Momentos (segundos desde epoch) no decrecientes, guardados en bloques de hasta
+// EVENTOS_POR_BLOQUE. Cada bloque guarda su primer momento completo y el resto
+// como deltas en varint (LEB128): una visita diaria ocupa 3 bytes.
+// Las consultas por rango saltan por el indice de bloques y solo decodifican
+// los bloques de los extremos.
+class SerieTemporal {
+public:
+    static constexpr std::uint32_t EVENTOS_POR_BLOQUE = 128;
+
+    struct Bloque {
+        std::int64_t inicio;
+        std::uint32_t offset;   // primer byte de sus deltas dentro de 'datos'
+        std::uint32_t eventos;
+    };
+
+private:
+    std::vector<Bloque> bloques;
+    std::vector<std::uint8_t> datos;
+    std::int64_t ultimo = 0;
+
+    static void escribirVarint(std::vector<std::uint8_t>& destino, std::uint64_t valor) {
+        while (valor >= 0x80) {
+            destino.push_back(static_cast<std::uint8_t>(valor | 0x80));
+            valor >>= 7;
+        }
+        destino.push_back(static_cast<std::uint8_t>(valor));
+    }
+
+    static std::uint64_t leerVarint(const std::uint8_t*& p) {
+        std::uint64_t valor = 0;
+        int desplazamiento = 0;
+        while (*p & 0x80) {
+            valor |= static_cast<std::uint64_t>(*p++ & 0x7F) << desplazamiento;
+            desplazamiento += 7;
+        }
+        return valor | (static_cast<std::uint64_t>(*p++) << desplazamiento);
+    }
+
+    // Como leerVarint, pero sin pasar de 'fin' ni de 10 bytes (datos de disco)
+    static bool leerVarintAcotado(const std::uint8_t*& p, const std::uint8_t* fin,
+                                  std::uint64_t& valor) {
+        valor = 0;
+        for (int desplazamiento = 0; p < fin && desplazamiento < 64; desplazamiento += 7) {
+            std::uint8_t byte = *p++;
+            valor |= static_cast<std::uint64_t>(byte & 0x7F) << desplazamiento;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    // Momento del evento mas tardio posible del bloque b
+    std::int64_t finBloque(std::size_t b) const {
+        return b + 1 < bloques.size() ? bloques[b + 1].inicio : ultimo;
+    }
+
+public:
+    // Un momento anterior al ultimo (reloj ajustado) se guarda como el ultimo
+    void agregar(std::int64_t momento, std::uint32_t repeticiones = 1) {
+        momento = std::max(momento, ultimo);
+        for (std::uint32_t r = 0; r < repeticiones; r++) {
+            if (bloques.empty() || bloques.back().eventos == EVENTOS_POR_BLOQUE) {
+                bloques.push_back({momento, static_cast<std::uint32_t>(datos.size()), 1});
+            } else {
+                escribirVarint(datos, static_cast<std::uint64_t>(momento - ultimo));
+                bloques.back().eventos++;
+            }
+            ultimo = momento;
+        }
+    }
+
+    // Llama funcion(momento) para cada evento con desde <= momento < hasta
+    template <typename Funcion>
+    void paraCadaEntre(std::int64_t desde, std::int64_t hasta, Funcion&& funcion) const {
+        auto it = std::upper_bound(bloques.begin(), bloques.end(), desde,
+                                   [](std::int64_t t, const Bloque& b) { return t < b.inicio; });
+        std::size_t b = it == bloques.begin() ? 0 : (it - bloques.begin()) - 1;
+        for (; b < bloques.size() && bloques[b].inicio < hasta; b++) {
+            const std::uint8_t* p = datos.data() + bloques[b].offset;
+            std::int64_t t = bloques[b].inicio;
+            for (std::uint32_t k = 0; k < bloques[b].eventos; k++) {
+                if (k > 0) t += static_cast<std::int64_t>(leerVarint(p));
+                if (t >= hasta) return;
+                if (t >= desde) funcion(t);
+            }
+        }
+    }
+
+    std::size_t contarEntre(std::int64_t desde, std::int64_t hasta) const {
+        std::size_t total = 0;
+        auto it = std::upper_bound(bloques.begin(), bloques.end(), desde,
+                                   [](std::int64_t t, const Bloque& b) { return t < b.inicio; });
+        std::size_t b = it == bloques.begin() ? 0 : (it - bloques.begin()) - 1;
+        for (; b < bloques.size() && bloques[b].inicio < hasta; b++) {
+            if (bloques[b].inicio >= desde && finBloque(b) < hasta) {
+                total += bloques[b].eventos;  // bloque completo dentro del rango
+                continue;
+            }
+            const std::uint8_t* p = datos.data() + bloques[b].offset;
+            std::int64_t t = bloques[b].inicio;
+            for (std::uint32_t k = 0; k < bloques[b].eventos; k++) {
+                if (k > 0) t += static_cast<std::int64_t>(leerVarint(p));
+                if (t >= hasta) break;
+                if (t >= desde) total++;
+            }
+        }
+        return total;
+    }
+
+    std::size_t size() const {
+        return bloques.empty() ? 0
+                               : (bloques.size() - 1) * EVENTOS_POR_BLOQUE + bloques.back().eventos;
+    }
+    std::size_t bytesUsados() const { return bloques.size() * sizeof(Bloque) + datos.size(); }
+
+    // Copia cruda para serializar despues, fuera del bloqueo: agrega bloques y
+    // deltas al final de los destinos (offsets relativos a esta serie) y
+    // devuelve 'ultimo'
+    std::int64_t copiarCrudo(std::vector<Bloque>& destinoBloques,
+                             std::vector<std::uint8_t>& destinoDatos) const {
+        destinoBloques.insert(destinoBloques.end(), bloques.begin(), bloques.end());
+        destinoDatos.insert(destinoDatos.end(), datos.begin(), datos.end());
+        return ultimo;
+    }
+
+    static SerieTemporal desdeCrudo(const Bloque* bloques, std::uint32_t numBloques,
+                                    const std::uint8_t* datos, std::uint32_t tamDatos,
+                                    std::int64_t ultimo) {
+        SerieTemporal serie;
+        serie.bloques.assign(bloques, bloques + numBloques);
+        serie.datos.assign(datos, datos + tamDatos);
+        serie.ultimo = ultimo;
+        return serie;
+    }
+
+    // Formato: [u32 numBloques][u32 tamDatos][i64 ultimo][Bloque...][datos]
+    static void serializarCrudo(std::string& destino, const Bloque* bloques,
+                                std::uint32_t numBloques, const std::uint8_t* datos,
+                                std::uint32_t tamDatos, std::int64_t ultimo) {
+        destino.append(reinterpret_cast<const char*>(&numBloques), sizeof(numBloques));
+        destino.append(reinterpret_cast<const char*>(&tamDatos), sizeof(tamDatos));
+        destino.append(reinterpret_cast<const char*>(&ultimo), sizeof(ultimo));
+        destino.append(reinterpret_cast<const char*>(bloques), numBloques * sizeof(Bloque));
+        destino.append(reinterpret_cast<const char*>(datos), tamDatos);
+    }
+
+    void serializar(std::string& destino) const {
+        serializarCrudo(destino, bloques.data(), static_cast<std::uint32_t>(bloques.size()),
+                        datos.data(), static_cast<std::uint32_t>(datos.size()), ultimo);
+    }
+
+    // Datos leidos de disco: ademas del largo se valida que cada bloque tenga
+    // entre 1 y EVENTOS_POR_BLOQUE eventos, que sus deltas ocupen exactamente
+    // [offset, offset del siguiente), empezando en 0, y que los momentos no
+    // decrezcan. Si algo no cuadra la serie queda vacia y devuelve false.
+    bool deserializar(const char* p, std::size_t largo) {
+        bloques.clear();
+        datos.clear();
+        ultimo = 0;
+        std::uint32_t numBloques, tamDatos;
+        const std::size_t cabecera = 2 * sizeof(std::uint32_t) + sizeof(std::int64_t);
+        if (largo < cabecera) return false;
+        std::memcpy(&numBloques, p, sizeof(numBloques));
+        std::memcpy(&tamDatos, p + 4, sizeof(tamDatos));
+        if (largo != cabecera + std::size_t(numBloques) * sizeof(Bloque) + tamDatos) return false;
+        std::int64_t ultimoLeido;
+        std::memcpy(&ultimoLeido, p + 8, sizeof(ultimoLeido));
+        std::vector<Bloque> bloquesLeidos(numBloques);
+        if (numBloques > 0) {
+            std::memcpy(bloquesLeidos.data(), p + cabecera, numBloques * sizeof(Bloque));
+        }
+        const std::uint8_t* inicioDatos =
+            reinterpret_cast<const std::uint8_t*>(p + cabecera + numBloques * sizeof(Bloque));
+
+        std::int64_t t = std::numeric_limits<std::int64_t>::min();
+        for (std::size_t b = 0; b < numBloques; b++) {
+            const Bloque& bloque = bloquesLeidos[b];
+            const std::uint32_t fin = b + 1 < numBloques ? bloquesLeidos[b + 1].offset : tamDatos;
+            if (bloque.eventos == 0 || bloque.eventos > EVENTOS_POR_BLOQUE ||
+                (b == 0 && bloque.offset != 0) || bloque.offset > fin || fin > tamDatos ||
+                bloque.inicio < t) {
+                return false;
+            }
+            const std::uint8_t* q = inicioDatos + bloque.offset;
+            t = bloque.inicio;
+            for (std::uint32_t k = 1; k < bloque.eventos; k++) {
+                std::uint64_t delta;
+                constexpr std::int64_t maximo = std::numeric_limits<std::int64_t>::max();
+                if (!leerVarintAcotado(q, inicioDatos + fin, delta) ||
+                    delta > static_cast<std::uint64_t>(maximo) ||
+                    t > maximo - static_cast<std::int64_t>(delta)) {
+                    return false;
+                }
+                t += static_cast<std::int64_t>(delta);
+            }
+            if (q != inicioDatos + fin) return false;
+        }
+        if (numBloques > 0 ? ultimoLeido != t : ultimoLeido != 0) return false;
+
+        bloques = std::move(bloquesLeidos);
+        datos.assign(inicioDatos, inicioDatos + tamDatos);
+        ultimo = ultimoLeido;
+        return true;
+    }
+};
+
+// Conteo de asistencias de todo el gimnasio por hora (UTC) desde 1970, en tramos
+// de HORAS_POR_TRAMO contadores atomicos que se reservan al primer uso: 16 KiB
+// por cada ~170 dias con actividad. Registrar y consultar no toman bloqueos;
+// solo el primer registro que cae en un tramo nuevo toma el mutex para crearlo.
+class AsistenciasPorHora {
+public:
+    static constexpr std::size_t HORAS_POR_TRAMO = 4096;
+    static constexpr std::size_t NUM_TRAMOS = 512;  // ~239 anios desde 1970
+
+private:
+    using Tramo = std::array<std::atomic<std::uint32_t>, HORAS_POR_TRAMO>;
+    std::array<std::atomic<Tramo*>, NUM_TRAMOS> tramos{};
+    std::mutex mutexTramos;
+
+    static std::int64_t horaDe(std::int64_t momento) {
+        return momento >= 0 ? momento / 3600 : (momento - 3599) / 3600;
+    }
+    static bool enRango(std::int64_t hora) {
+        return hora >= 0 && hora < static_cast<std::int64_t>(NUM_TRAMOS * HORAS_POR_TRAMO);
+    }
+
+    std::atomic<std::uint32_t>* contador(std::int64_t hora) const {
+        Tramo* t = tramos[hora / HORAS_POR_TRAMO].load(std::memory_order_acquire);
+        return t != nullptr ? &(*t)[hora % HORAS_POR_TRAMO] : nullptr;
+    }
+
+    std::atomic<std::uint32_t>& contadorCreando(std::int64_t hora) {
+        std::atomic<Tramo*>& ranura = tramos[hora / HORAS_POR_TRAMO];
+        Tramo* t = ranura.load(std::memory_order_acquire);
+        if (t == nullptr) {
+            std::lock_guard<std::mutex> bloqueo(mutexTramos);
+            t = ranura.load(std::memory_order_relaxed);
+            if (t == nullptr) {
+                t = new Tramo();
+                for (auto& c : *t) c.store(0, std::memory_order_relaxed);
+                ranura.store(t, std::memory_order_release);
+            }
+        }
+        return (*t)[hora % HORAS_POR_TRAMO];
+    }
+
+public:
+    AsistenciasPorHora() = default;
+    AsistenciasPorHora(const AsistenciasPorHora&) = delete;
+    AsistenciasPorHora& operator=(const AsistenciasPorHora&) = delete;
+    ~AsistenciasPorHora() {
+        for (auto& t : tramos) delete t.load(std::memory_order_relaxed);
+    }
+
+    // Momentos antes de 1970 o despues del ultimo tramo no se cuentan
+    void registrar(std::int64_t momento, std::uint32_t cantidad) {
+        std::int64_t hora = horaDe(momento);
+        if (!enRango(hora)) return;
+        contadorCreando(hora).fetch_add(cantidad, std::memory_order_relaxed);
+    }
+
+    // Un conteo por hora para las horas que empiezan en [desde, hasta)
+    std::vector<std::uint32_t> consultar(std::int64_t desde, std::int64_t hasta) const {
+        std::int64_t primera = horaDe(desde);
+        std::int64_t ultima = horaDe(hasta - 1);
+        std::vector<std::uint32_t> resultado(
+            ultima >= primera ? static_cast<std::size_t>(ultima - primera + 1) : 0, 0);
+        for (std::size_t k = 0; k < resultado.size(); k++) {
+            std::int64_t hora = primera + static_cast<std::int64_t>(k);
+            const std::atomic<std::uint32_t>* c = enRango(hora) ? contador(hora) : nullptr;
+            if (c != nullptr) resultado[k] = c->load(std::memory_order_relaxed);
+        }
+        return resultado;
+    }
+
+    // funcion(momentoInicioHora, conteo) para cada hora con asistencias
+    template <typename Funcion>
+    void paraCada(Funcion&& funcion) const {
+        for (std::size_t i = 0; i < NUM_TRAMOS; i++) {
+            const Tramo* t = tramos[i].load(std::memory_order_acquire);
+            if (t == nullptr) continue;
+            for (std::size_t k = 0; k < HORAS_POR_TRAMO; k++) {
+                std::uint32_t conteo = (*t)[k].load(std::memory_order_relaxed);
+                if (conteo > 0) {
+                    funcion(static_cast<std::int64_t>(i * HORAS_POR_TRAMO + k) * 3600, conteo);
+                }
+            }
+        }
+    }
+
+    // Conteos densos desde la primera hora con asistencias hasta la ultima, como
+    // se guardan en el snapshot; 'horaBase' recibe la primera
+    std::vector<std::uint32_t> copiarConteos(std::int64_t& horaBase) const {
+        std::vector<std::uint32_t> conteos;
+        horaBase = 0;
+        paraCada([&](std::int64_t momento, std::uint32_t conteo) {
+            std::int64_t hora = momento / 3600;
+            if (conteos.empty()) horaBase = hora;
+            conteos.resize(static_cast<std::size_t>(hora - horaBase) + 1, 0);
+            conteos.back() = conteo;
+        });
+        return conteos;
+    }
+
+    // Reemplaza todo el contenido; no debe correr junto con registrar()
+    void cargar(std::int64_t base, const std::uint32_t* valores, std::size_t cantidad) {
+        clear();
+        for (std::size_t i = 0; i < cantidad; i++) {
+            std::int64_t hora = base + static_cast<std::int64_t>(i);
+            if (valores[i] > 0 && enRango(hora)) {
+                contadorCreando(hora).store(valores[i], std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pone todo en cero (los tramos ya creados se conservan)
+    void clear() {
+        for (auto& ranura : tramos) {
+            Tramo* t = ranura.load(std::memory_order_acquire);
+            if (t == nullptr) continue;
+            for (auto& c : *t) c.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// =================================================================================
+// ARCHIVO: Membresia.h
+// RESPONSABILIDAD: Tipos de membresia y la politica asociada a cada uno
+// =================================================================================
+
+enum class TipoMembresia : std::uint8_t {
+    Basica,
+    Premium,
+    VIP,
+    Cantidad  // marcador: numero de tipos, no es un tipo valido
+};
+
+struct PoliticaMembresia {
+    const char* nombre;
+    int limiteClases;
+    int prioridad;  // mayor valor = mayor prioridad (listas de espera, etc.)
+};
+
+// Una fila por tipo, en el mismo orden que el enum. Agregar un tipo sin su fila
+// (o viceversa) no compila por el static_assert.
+constexpr PoliticaMembresia POLITICAS_MEMBRESIA[] = {
+    {"Basica", 2, 1},
+    {"Premium", 5, 2},
+    {"VIP", 999, 3},
+};
+static_assert(sizeof(POLITICAS_MEMBRESIA) / sizeof(POLITICAS_MEMBRESIA[0]) ==
+                  static_cast<std::size_t>(TipoMembresia::Cantidad),
+              "Cada TipoMembresia necesita su fila en POLITICAS_MEMBRESIA");
+
+constexpr const PoliticaMembresia& politicaMembresia(TipoMembresia tipo) {
+    return POLITICAS_MEMBRESIA[static_cast<std::size_t>(tipo)];
+}
+
+// Convierte el nombre ("Basica", "Premium", "VIP") al enum; false si no existe
+inline bool parsearTipoMembresia(std::string_view texto, TipoMembresia& tipo) {
+    for (std::size_t i = 0; i < static_cast<std::size_t>(TipoMembresia::Cantidad); i++) {
+        if (texto == POLITICAS_MEMBRESIA[i].nombre) {
+            tipo = static_cast<TipoMembresia>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// =================================================================================
+// ARCHIVO: Miembro.h
+// RESPONSABILIDAD: Representa un miembro del gimnasio
+// =================================================================================
+
+// Lo que se muestra de un miembro, copiado bajo su shard
+struct FilaMiembro {
+    int idMiembro;
+    std::string nombre;
+    TipoMembresia tipo;
+    bool activo;
+    int diasAsistencia;
+    std::size_t asistenciasRecientes;  // ultimos 30 dias
+    int clasesInscritas;
+
+    const char* getNombreMembresia() const { return politicaMembresia(tipo).nombre; }
+    void escribirInformacion(SalidaBuffer& salida) const;
+};
+
+class Miembro {
+private:
+    std::string nombre;
+    int idMiembro;
+    TipoMembresia tipoMembresia;
+    bool membresiaActiva;
+    int diasAsistencia;
+    std::vector<IdClase> clasesInscritas;
+    AgendaSemanal agenda;     // franjas ocupadas por las clases inscritas
+    SerieTemporal historial;  // momento de cada asistencia
+    std::uint32_t version;    // cambia con cada mutacion (la captura de snapshot la compara)
+
+public:
+    Miembro(const std::string& nombre, int idMiembro, TipoMembresia tipoMembresia);
+
+    // Getters
+    const std::string& getNombre() const { return nombre; }
+    int getIdMiembro() const { return idMiembro; }
+    TipoMembresia getTipoMembresia() const { return tipoMembresia; }
+    const PoliticaMembresia& getPolitica() const { return politicaMembresia(tipoMembresia); }
+    const char* getNombreMembresia() const { return getPolitica().nombre; }
+    bool estaActivo() const { return membresiaActiva; }
+    int getDiasAsistencia() const { return diasAsistencia; }
+    std::uint32_t getVersion() const { return version; }
+
+    // Setters
+    void setMembresiaActiva(bool estado) {
+        membresiaActiva = estado;
+        version++;
+    }
+    void setTipoMembresia(TipoMembresia tipo) {
+        tipoMembresia = tipo;
+        version++;
+    }
+    void setDiasAsistencia(int dias) {
+        diasAsistencia = dias;
+        version++;
+    }
+
+    // Métodos de operación
+    void registrarAsistencia(std::int64_t momento);
+    void sumarAsistencias(int cantidad, std::int64_t momento);
+    const SerieTemporal& getHistorial() const { return historial; }
+    SerieTemporal& getHistorial() { return historial; }  // solo al cargar (no cambia version)
+    void inscribirseAClase(IdClase clase, const std::vector<IntervaloSemanal>& intervalos);
+    void cancelarClase(IdClase clase);
+    const AgendaSemanal& getAgenda() const { return agenda; }
+    int getCantidadClasesInscritas() const { return clasesInscritas.size(); }
+    void reservarClases(std::size_t n) {
+        clasesInscritas.reserve(n);
+        agenda.reserve(n);
+    }
+    const std::vector<IdClase>& getClasesInscritas() const { return clasesInscritas; }
+    FilaMiembro capturarFila(std::int64_t ahora) const;
+    void escribirInformacion(SalidaBuffer& salida, std::int64_t ahora) const;
+    void mostrarInformacion() const;
+};
+
+// =================================================================================
+// ARCHIVO: ColumnasMiembros.h
+// RESPONSABILIDAD: Vista columnar (estructura de arreglos) de los campos calientes
+// =================================================================================
+
+// Copia de id, membresia, estado y asistencias de cada miembro, indexada por el
+// mismo slot que el registro. Los reportes recorren arreglos contiguos de pocos
+// bytes por miembro en lugar de objetos Miembro con nombres y vectores.
+class ColumnasMiembros {
+public:
+    std::vector<std::int32_t> ids;
+    std::vector<std::uint8_t> tipos;
+    std::vector<std::uint8_t> activos;
+    std::vector<std::int32_t> dias;
+
+    void agregar(const Miembro& m) {
+        ids.push_back(m.getIdMiembro());
+        tipos.push_back(static_cast<std::uint8_t>(m.getTipoMembresia()));
+        activos.push_back(m.estaActivo() ? 1 : 0);
+        dias.push_back(m.getDiasAsistencia());
+    }
+
+    // Refleja el estado y las asistencias actuales del miembro en el slot h
+    void actualizar(Handle h, const Miembro& m) {
+        activos[h] = m.estaActivo() ? 1 : 0;
+        dias[h] = m.getDiasAsistencia();
+    }
+
+    void reserve(std::size_t n) {
+        ids.reserve(n);
+        tipos.reserve(n);
+        activos.reserve(n);
+        dias.reserve(n);
+    }
+
+    void clear() {
+        ids.clear();
+        tipos.clear();
+        activos.clear();
+        dias.clear();
+    }
+
+    std::size_t size() const { return ids.size(); }
+};
+
+struct ResumenColumnas {
+    std::int64_t miembros;
+    std::int64_t activos;
+    std::int64_t asistencias;
+};
+
+// Kernels de agregacion: bucles sin ramas sobre arreglos contiguos, pensados
+// para que el compilador los vectorice (-O2/-O3).
+inline ResumenColumnas resumirPorTipo(const ColumnasMiembros& c, std::uint8_t tipo) {
+    const std::uint8_t* tipos = c.tipos.data();
+    const std::uint8_t* activos = c.activos.data();
+    const std::int32_t* dias = c.dias.data();
+    const std::size_t n = c.size();
+    std::int64_t miembros = 0, activosTipo = 0, asistencias = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        std::int32_t coincide = tipos[i] == tipo;
+        miembros += coincide;
+        activosTipo += coincide & activos[i];
+        asistencias += coincide * dias[i];
+    }
+    return {miembros, activosTipo, asistencias};
+}
+
+// Cantidad de miembros con desde <= asistencias < hasta
+inline std::int64_t contarEnRango(const ColumnasMiembros& c, std::int32_t desde,
+                                  std::int32_t hasta) {
+    const std::int32_t* dias = c.dias.data();
+    const std::size_t n = c.size();
+    std::int64_t total = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        total += (dias[i] >= desde) & (dias[i] < hasta);
+    }
+    return total;
+}
+
+// Slots de los k miembros con mas asistencias, de mayor a menor
+inline std::vector<Handle> mayoresAsistentes(const ColumnasMiembros& c, std::size_t k) {
+    std::vector<Handle> slots(c.size());
+    for (std::size_t i = 0; i < slots.size(); i++) slots[i] = static_cast<Handle>(i);
+    k = std::min(k, slots.size());
+    std::partial_sort(slots.begin(), slots.begin() + k, slots.end(),
+                      [&](Handle a, Handle b) { return c.dias[a] > c.dias[b]; });
+    slots.resize(k);
+    return slots;
+}
+
+// =================================================================================
+// ARCHIVO: IndiceNombres.h
+// RESPONSABILIDAD: Indices secundarios por prefijo de nombre y por instructor
+// =================================================================================
+
+// Minusculas, sin acentos (á->a, ñ->n, ü->u... en UTF-8) y con los espacios
+// colapsados a uno y recortados: "  JOSÉ  Pérez" y "jose perez" son iguales
+void normalizarTexto(std::string_view texto, std::string& destino);
+
+// Prefijos de nombre normalizado. Cada palabra del nombre abre una entrada, asi
+// "per" encuentra a "Beto Pérez" igual que "beto p". Las claves viven en un solo
+// bloque de texto y las entradas son vistas ordenadas sobre el. Las altas sueltas
+// van a un tramo reciente chico y ordenado que se funde con el principal al
+// llenarse: una alta no desplaza el arreglo grande.
+class IndicePrefijos {
+public:
+    static constexpr std::size_t MAX_RECIENTES = 1024;
+
+private:
+    struct Entrada {
+        std::uint32_t offset;  // inicio de la palabra dentro de 'claves'
+        std::uint32_t largo;   // hasta el final del nombre
+        Handle handle;
+    };
+    std::string claves;
+    std::vector<Entrada> principal;
+    std::vector<Entrada> recientes;
+    std::size_t principalOrdenado = 0;  // prefijo de 'principal' ya ordenado
+    std::string normalizado;            // buffer reutilizado entre altas
+
+    std::string_view clave(const Entrada& e) const {
+        return std::string_view(claves.data() + e.offset, e.largo);
+    }
+    bool menor(const Entrada& a, const Entrada& b) const {
+        int c = clave(a).compare(clave(b));
+        return c < 0 || (c == 0 && a.handle < b.handle);
+    }
+    // Normaliza el nombre, lo agrega a 'claves' y agrega una entrada por palabra
+    void anotar(std::string_view nombre, Handle h, std::vector<Entrada>& destino);
+
+public:
+    void agregar(std::string_view nombre, Handle h);
+    // Altas masivas (cargas, importaciones): se ordenan juntas al llamar ordenar()
+    void agregarSinOrdenar(std::string_view nombre, Handle h) { anotar(nombre, h, principal); }
+    void ordenar();
+    void clear();
+    std::size_t bytesUsados() const {
+        return claves.capacity() + (principal.capacity() + recientes.capacity()) * sizeof(Entrada);
+    }
+
+    // funcion(handle) en orden de clave para cada entrada que empieza con el prefijo
+    // (ya normalizado) hasta que devuelva false. Un nombre con varias palabras que
+    // coinciden aparece una vez por palabra.
+    template <typename Funcion>
+    void paraCadaConPrefijo(std::string_view prefijo, Funcion&& funcion) const;
+};
+
+template <typename Funcion>
+void IndicePrefijos::paraCadaConPrefijo(std::string_view prefijo, Funcion&& funcion) const {
+    auto desde = [&](const std::vector<Entrada>& v) {
+        return std::lower_bound(v.begin(), v.end(), prefijo,
+                                [this](const Entrada& e, std::string_view p) {
+                                    return clave(e) < p;
+                                });
+    };
+    auto coincide = [&](const std::vector<Entrada>& v, std::vector<Entrada>::const_iterator it) {
+        return it != v.end() && clave(*it).substr(0, prefijo.size()) == prefijo;
+    };
+    // Mezcla de los dos tramos ordenados
+    auto a = desde(principal);
+    auto b = desde(recientes);
+    while (true) {
+        bool hayA = coincide(principal, a);
+        bool hayB = coincide(recientes, b);
+        if (!hayA && !hayB) return;
+        bool tomarA = hayA && (!hayB || !menor(*b, *a));
+        if (!funcion((tomarA ? a++ : b++)->handle)) return;
+    }
+}
+
+// Instructor normalizado -> clases que dicta, en orden de creacion
+class IndiceInstructores {
+private:
+    std::unordered_map<std::string, std::vector<IdClase>> clasesPorInstructor;
+    std::string normalizado;  // buffer reutilizado entre altas
+
+public:
+    void agregar(std::string_view instructor, IdClase clase) {
+        normalizarTexto(instructor, normalizado);
+        clasesPorInstructor[normalizado].push_back(clase);
+    }
+
+    // nullptr si el instructor no dicta ninguna clase
+    const std::vector<IdClase>* buscar(std::string_view instructor) const {
+        std::string clave;
+        normalizarTexto(instructor, clave);
+        auto it = clasesPorInstructor.find(clave);
+        return it != clasesPorInstructor.end() ? &it->second : nullptr;
+    }
+
+    void clear() { clasesPorInstructor.clear(); }
+};
+
+// =================================================================================
+// ARCHIVO: ContadorDiario.h
+// RESPONSABILIDAD: Asistencias por dia calendario con rotacion automatica
+// =================================================================================
+
+// Segundos desde epoch (UTC) y dia calendario local correspondiente
+inline std::int64_t momentoActual() {
+    return static_cast<std::int64_t>(std::time(nullptr));
+}
+
+inline std::int64_t diaLocal(std::int64_t momento) {
+    std::time_t t = static_cast<std::time_t>(momento);
+    std::tm local;
+    localtime_r(&t, &local);
+    std::int64_t segundosLocales = momento + local.tm_gmtoff;
+    return segundosLocales >= 0 ? segundosLocales / 86400 : (segundosLocales - 86399) / 86400;
+}
+
+// Anillo de cubetas, una por dia (dia % DIAS). Registrar y consultar son O(1)
+// y sin bloqueo; solo el primer registro de un dia nuevo toma el mutex para
+// reiniciar la cubeta que se recicla.
+class ContadorDiario {
+public:
+    static constexpr std::size_t DIAS = 32;
+
+private:
+    struct Cubeta {
+        std::atomic<std::int64_t> dia{-1};
+        std::atomic<std::int64_t> conteo{0};
+    };
+    std::array<Cubeta, DIAS> cubetas;
+    std::mutex mutexRotacion;
+
+    Cubeta& cubeta(std::int64_t dia) {
+        return cubetas[static_cast<std::uint64_t>(dia) % DIAS];
+    }
+
+public:
+    // Un dia mas viejo que el que ocupa su cubeta ya salio de la ventana y se ignora
+    void registrar(std::int64_t dia, std::int64_t cantidad) {
+        Cubeta& c = cubeta(dia);
+        if (c.dia.load(std::memory_order_acquire) != dia) {
+            std::lock_guard<std::mutex> bloqueo(mutexRotacion);
+            std::int64_t actual = c.dia.load(std::memory_order_relaxed);
+            if (actual > dia) return;
+            if (actual != dia) {
+                c.conteo.store(0, std::memory_order_relaxed);
+                c.dia.store(dia, std::memory_order_release);
+            }
+        }
+        c.conteo.fetch_add(cantidad, std::memory_order_relaxed);
+    }
+
+    std::int64_t consultar(std::int64_t dia) const {
+        const Cubeta& c = cubetas[static_cast<std::uint64_t>(dia) % DIAS];
+        return c.dia.load(std::memory_order_acquire) == dia
+                   ? c.conteo.load(std::memory_order_relaxed)
+                   : 0;
+    }
+
+    void reiniciar() {
+        std::lock_guard<std::mutex> bloqueo(mutexRotacion);
+        for (auto& c : cubetas) {
+            c.dia.store(-1);
+            c.conteo.store(0);
+        }
+    }
+};
+
+// =================================================================================
+// ARCHIVO: Snapshot.h
+// RESPONSABILIDAD: Formato binario versionado del estado del gimnasio
+// =================================================================================
+
+// Disposicion del archivo (orden de bytes nativo):
+//   CabeceraSnapshot
+//   RegistroMiembroBin[numMiembros]
+//   RegistroClaseBin[numClases]
+//   tabla de cadenas (bytes UTF-8 concatenados, sin terminador)
+//   tabla de historiales (SerieTemporal serializadas una tras otra)
+//   u32[numHoras] asistencias por hora desde horaBase
+//   inscripciones en CSR, ambos sentidos, con nodos = indice del registro:
+//     u32 filasClase[numClases + 1],     u32 miembrosDeClase[numAristas]
+//     u32 filasMiembro[numMiembros + 1], u32 clasesDeMiembro[numAristas]
+//   listas de espera, una fila por clase:
+//     u32 filasEspera[numClases + 1],    EntradaEsperaBin[numEspera]
+// Los registros son de ancho fijo; textos e historiales se referencian por
+// (offset, largo) dentro de su tabla.
+constexpr char MAGIA_SNAPSHOT[8] = {'G', 'Y', 'M', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t VERSION_SNAPSHOT = 6;
+
+struct RefCadena {
+    std::uint32_t offset;
+    std::uint32_t largo;
+};
+
+struct CabeceraSnapshot {
+    char magia[8];
+    std::uint32_t version;
+    std::uint32_t numMiembros;
+    std::uint32_t numClases;
+    std::uint32_t tamCadenas;
+    std::uint64_t offMiembros;
+    std::uint64_t offClases;
+    std::uint64_t offCadenas;
+    std::uint64_t secuenciaJournal;  // ultima operacion del journal incluida
+    std::uint64_t offHistorial;
+    std::uint64_t tamHistorial;
+    std::uint64_t offHoras;
+    std::uint64_t numHoras;
+    std::int64_t horaBase;
+    std::uint64_t offInscripciones;
+    std::uint64_t numAristas;
+    std::uint64_t offEspera;
+    std::uint64_t numEspera;
+};
+
+struct RegistroMiembroBin {
+    std::int32_t idMiembro;
+    RefCadena nombre;
+    std::int32_t diasAsistencia;
+    std::uint8_t activo;
+    std::uint8_t tipoMembresia;  // valor de TipoMembresia
+    std::uint8_t relleno[2];
+    RefCadena historial;         // dentro de la tabla de historiales
+};
+
+struct RegistroClaseBin {
+    RefCadena nombre;
+    RefCadena instructor;
+    RefCadena horario;
+    RefCadena codigo;
+    std::int32_t capacidadMaxima;
+};
+
+// Entrada de lista de espera; 'orden' conserva el desempate por llegada
+struct EntradaEsperaBin {
+    std::int32_t idMiembro;
+    std::int32_t prioridad;
+    std::uint64_t orden;
+};
+
+// Copia del estado tomada bajo el bloqueo exclusivo: solo copias planas (ids,
+// banderas, bytes de los textos y buffers de historial tal como estan en
+// memoria). Los registros del archivo, la serializacion de los historiales y
+// las inscripciones por clase se arman despues, ya sin bloqueos.
+struct CapturaSnapshot {
+    struct MiembroCrudo {
+        std::int32_t idMiembro;
+        std::uint8_t tipoMembresia;
+        std::uint8_t activo;
+        std::int32_t diasAsistencia;
+        RefCadena nombre;             // dentro de 'textos'
+        std::uint32_t offBloques;     // historial: dentro de 'bloques' y 'datos'
+        std::uint32_t numBloques;
+        std::uint32_t offDatos;
+        std::uint32_t tamDatos;
+        std::int64_t ultimo;
+        std::uint32_t offClases;      // clases inscritas: dentro de 'clasesMiembro'
+        std::uint32_t numClases;
+        std::uint32_t version;        // Miembro::getVersion() al copiarlo
+    };
+
+    std::uint64_t secuenciaJournal = 0;
+    std::vector<MiembroCrudo> miembros;
+    std::vector<RegistroClaseBin> clases;
+    std::string textos;
+    std::vector<SerieTemporal::Bloque> bloques;
+    std::vector<std::uint8_t> datos;
+    std::int64_t horaBase = 0;
+    std::vector<std::uint32_t> horas;
+    std::vector<IdClase> clasesMiembro;
+    GrafoCSR porMiembro;  // fila = slot de miembro, vecinos = slots de sus clases
+    std::vector<std::uint32_t> filasEspera{0};
+    std::vector<EntradaEsperaBin> espera;
+
+    std::string_view texto(const RefCadena& ref) const {
+        return std::string_view(textos).substr(ref.offset, ref.largo);
+    }
+    SerieTemporal historial(const MiembroCrudo& m) const {
+        return SerieTemporal::desdeCrudo(bloques.data() + m.offBloques, m.numBloques,
+                                         datos.data() + m.offDatos, m.tamDatos, m.ultimo);
+    }
+
+    // Agrega al final de la captura el estado del miembro; el nombre no cambia
+    // nunca, asi que una segunda copia reusa la referencia de la primera
+    MiembroCrudo copiarMiembro(const Miembro& m, RefCadena nombre);
+    // Arma el archivo completo tal como va a disco
+    std::string armarImagen() const;
+};
+
+// Mapea un archivo completo en memoria de solo lectura (RAII)
+class ArchivoMapeado {
+private:
+    const char* datos;
+    std::size_t tam;
+
+public:
+    explicit ArchivoMapeado(const std::string& ruta) : datos(nullptr), tam(0) {
+        int fd = ::open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                datos = static_cast<const char*>(p);
+                tam = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+
+    ~ArchivoMapeado() {
+        if (datos != nullptr) ::munmap(const_cast<char*>(datos), tam);
+    }
+
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    bool valido() const { return datos != nullptr; }
+    const char* data() const { return datos; }
+    std::size_t size() const { return tam; }
+};
+
+// Escribe en ruta.tmp, fsync y rename sobre 'ruta': quien abra el archivo ve la
+// version anterior completa o la nueva completa, nunca una escrita a medias
+inline bool escribirArchivoAtomico(const std::string& ruta, const char* datos,
+                                   std::size_t largo) {
+    const std::string temporal = ruta + ".tmp";
+    int fd = ::open(temporal.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool correcto = true;
+    while (largo > 0) {
+        ssize_t n = ::write(fd, datos, largo);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            correcto = false;
+            break;
+        }
+        datos += n;
+        largo -= static_cast<std::size_t>(n);
+    }
+    correcto = correcto && ::fsync(fd) == 0;
+    correcto = ::close(fd) == 0 && correcto;
+    if (!correcto || ::rename(temporal.c_str(), ruta.c_str()) != 0) {
+        ::unlink(temporal.c_str());
+        return false;
+    }
+    return true;
+}
+
+// =================================================================================
+// ARCHIVO: Journal.h
+// RESPONSABILIDAD: Bitacora de escritura anticipada (solo agregar) de mutaciones
+// =================================================================================
+
+// Cada registro en disco:
+//   [u32 largoPayload][u64 secuencia][u8 tipo][payload][u32 checksum]
+// El checksum (FNV-1a) cubre secuencia, tipo y payload; un registro incompleto o
+// corrupto al final del archivo marca el punto donde se corta la reproduccion.
+enum class TipoRegistro : std::uint8_t {
+    RegistrarMiembro = 1,
+    CrearClase = 2,
+    Asistencia = 3,     // [id][momento i64, opcional]
+    Inscripcion = 4,
+    Cancelacion = 5,
+    CambioEstado = 6,
+    AsistenciaLote = 7, // [cantidad][id]...[momento i64, opcional]
+    Promocion = 8       // [id][codigo]: sale de la lista de espera (y entra si aun califica)
+};
+
+struct ConfigJournal {
+    std::size_t registrosPorLote = 64;  // group commit: escribe al juntar N registros
+    std::size_t lotesPorFsync = 1;      // fsync cada N lotes escritos (0 = nunca)
+};
+
+// Serializa los campos de un registro
+class EscritorRegistro {
+private:
+    std::string bytes;
+
+public:
+    void entero(std::int32_t valor) {
+        bytes.append(reinterpret_cast<const char*>(&valor), sizeof(valor));
+    }
+    void entero64(std::int64_t valor) {
+        bytes.append(reinterpret_cast<const char*>(&valor), sizeof(valor));
+    }
+    void texto(const std::string& valor) {
+        std::uint16_t largo = static_cast<std::uint16_t>(
+            std::min<std::size_t>(valor.size(), std::numeric_limits<std::uint16_t>::max()));
+        bytes.append(reinterpret_cast<const char*>(&largo), sizeof(largo));
+        bytes.append(valor.data(), largo);
+    }
+    const std::string& datos() const { return bytes; }
+};
+
+// Lee los campos de un registro; ok() queda en false si el payload no alcanza
+class LectorRegistro {
+private:
+    const char* actual;
+    const char* fin;
+    bool correcto;
+
+public:
+    LectorRegistro(const char* datos, std::size_t largo)
+        : actual(datos), fin(datos + largo), correcto(true) {}
+
+    std::int32_t entero() {
+        std::int32_t valor = 0;
+        if (fin - actual < static_cast<std::ptrdiff_t>(sizeof(valor))) {
+            correcto = false;
+            return 0;
+        }
+        std::memcpy(&valor, actual, sizeof(valor));
+        actual += sizeof(valor);
+        return valor;
+    }
+    std::int64_t entero64() {
+        std::int64_t valor = 0;
+        if (fin - actual < static_cast<std::ptrdiff_t>(sizeof(valor))) {
+            correcto = false;
+            return 0;
+        }
+        std::memcpy(&valor, actual, sizeof(valor));
+        actual += sizeof(valor);
+        return valor;
+    }
+    // Campos agregados en versiones posteriores van al final y son opcionales
+    bool quedanDatos() const { return actual < fin; }
+    std::string texto() {
+        std::uint16_t largo = 0;
+        if (fin - actual < static_cast<std::ptrdiff_t>(sizeof(largo))) {
+            correcto = false;
+            return std::string();
+        }
+        std::memcpy(&largo, actual, sizeof(largo));
+        actual += sizeof(largo);
+        if (fin - actual < largo) {
+            correcto = false;
+            return std::string();
+        }
+        std::string valor(actual, largo);
+        actual += largo;
+        return valor;
+    }
+    bool ok() const { return correcto; }
+};
+
+std::uint32_t checksumFnv1a(const char* datos, std::size_t largo);
+
+class Journal {
+private:
+    int fd;
+    std::string ruta;
+    ConfigJournal config;
+    std::string pendiente;  // registros aun no escritos (lote en curso)
+    std::size_t registrosPendientes;
+    std::size_t lotesSinFsync;
+    std::uint64_t ultimaSecuencia;
+
+    void escribirPendiente();
+
+public:
+    Journal();
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    bool abrir(const std::string& ruta, const ConfigJournal& config,
+               std::uint64_t secuenciaInicial);
+    std::uint64_t agregar(TipoRegistro tipo, const std::string& payload);
+    void confirmar();    // escribe el lote en curso (fsync segun config)
+    void sincronizar();  // escribe y fuerza fsync
+    // Checkpoint: el segmento actual pasa a rutaAnterior() y se sigue en uno vacio.
+    // Solo escribe lo pendiente, renombra y abre; devuelve el descriptor del
+    // segmento viejo para sincronizarlo y cerrarlo fuera del bloqueo, o -1 si no
+    // roto. Si quedo el segmento de un checkpoint fallido no se rota: la
+    // reproduccion salta por secuencia lo que el snapshot ya contiene.
+    int rotar();
+    const std::string& getRuta() const { return ruta; }
+    static std::string rutaAnterior(const std::string& ruta) { return ruta + ".anterior"; }
+
+    // Recorre los registros validos y devuelve cuantos bytes eran validos.
+    // Si el archivo termina en un registro roto, lo recorta a ese punto.
+    template <typename Funcion>
+    static std::size_t reproducir(const std::string& ruta, Funcion&& aplicar);
+};
+
+template <typename Funcion>
+std::size_t Journal::reproducir(const std::string& ruta, Funcion&& aplicar) {
+    ArchivoMapeado mapa(ruta);
+    if (!mapa.valido()) return 0;
+
+    const std::size_t cabecera = sizeof(std::uint32_t) + sizeof(std::uint64_t) + 1;
+    std::size_t offset = 0;
+    while (mapa.size() - offset >= cabecera + sizeof(std::uint32_t)) {
+        const char* p = mapa.data() + offset;
+        std::uint32_t largo;
+        std::memcpy(&largo, p, sizeof(largo));
+        std::size_t total = cabecera + largo + sizeof(std::uint32_t);
+        if (mapa.size() - offset < total) break;
+
+        std::uint32_t checksum;
+        std::memcpy(&checksum, p + cabecera + largo, sizeof(checksum));
+        if (checksum != checksumFnv1a(p + sizeof(largo), cabecera - sizeof(largo) + largo)) {
+            break;
+        }
+
+        std::uint64_t secuencia;
+        std::memcpy(&secuencia, p + sizeof(largo), sizeof(secuencia));
+        TipoRegistro tipo = static_cast<TipoRegistro>(p[cabecera - 1]);
+        LectorRegistro lector(p + cabecera, largo);
+        aplicar(secuencia, tipo, lector);
+        offset += total;
+    }
+
+    if (offset < mapa.size()) {
+        std::cout << "ADVERTENCIA: Journal '" << ruta << "' con registro incompleto; "
+                  << "se descartan " << (mapa.size() - offset) << " bytes.\n";
+        if (::truncate(ruta.c_str(), static_cast<off_t>(offset)) != 0) {
+            std::cout << "ERROR: No se pudo recortar el journal.\n";
+        }
+    }
+    return offset;
+}
+
+// =================================================================================
+// ARCHIVO: Resultado.h
+// RESPONSABILIDAD: Codigos de resultado de las operaciones
+// =================================================================================
+
+// Resultado de una operacion; los metodos publicos lo traducen a mensajes
+enum class CodigoResultado {
+    Ok,
+    MiembroNoEncontrado,
+    ClaseNoEncontrada,
+    MembresiaInactiva,
+    ClaseLlena,
+    YaInscrito,
+    NoInscrito,
+    LimiteClases,
+    IdDuplicado,
+    CodigoDuplicado,
+    MembresiaInvalida,
+    EnListaEspera,
+    ConflictoHorario
+};
+
+constexpr std::size_t NUM_CODIGOS_RESULTADO =
+    static_cast<std::size_t>(CodigoResultado::ConflictoHorario) + 1;
+const char* nombreResultado(CodigoResultado resultado);
+
+// =================================================================================
+// ARCHIVO: Metricas.h
+// RESPONSABILIDAD: Contadores e histogramas de latencia por operacion, sin bloqueos
+// =================================================================================
+
+enum class OperacionMedida : std::uint8_t {
+    RegistroMiembro,
+    CreacionClase,
+    Asistencia,
+    AsistenciaLote,  // una muestra por lote; los resultados cuentan cada ID
+    Inscripcion,
+    Cancelacion,
+    CambioEstado,
+    Consulta,        // historial de un miembro, clases por horario
+    Listado,         // una pagina de exportarMiembros/exportarClases
+    Guardado,
+    Carga,
+    Importacion,     // un CSV completo; los resultados cuentan cada fila
+    Cantidad
+};
+
+constexpr std::size_t NUM_OPERACIONES_MEDIDAS =
+    static_cast<std::size_t>(OperacionMedida::Cantidad);
+const char* nombreOperacion(OperacionMedida operacion);
+
+// Histograma log-lineal estilo HDR en nanosegundos: cada potencia de 2 se parte
+// en 8 cubetas, asi el error relativo de un percentil es como mucho 12.5% y el
+// rango cubre de 1 ns a 2^64 ns con 496 contadores fijos. Registrar es un par de
+// fetch_add relajados: se puede llamar desde cualquier hilo sin bloqueo.
+class HistogramaLatencia {
+public:
+    static constexpr int BITS_SUBCUBETA = 3;
+    static constexpr std::size_t SUBCUBETAS = std::size_t(1) << BITS_SUBCUBETA;
+    static constexpr std::size_t NUM_CUBETAS = (64 - BITS_SUBCUBETA + 1) * SUBCUBETAS;
+
+private:
+    std::array<std::atomic<std::uint64_t>, NUM_CUBETAS> cubetas{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> sumaNs{0};
+    std::atomic<std::uint64_t> maximoNs{0};
+
+    static std::size_t cubetaDe(std::uint64_t ns) {
+        if (ns < SUBCUBETAS) return static_cast<std::size_t>(ns);
+        int exponente = 63 - __builtin_clzll(ns);
+        std::size_t sub = (ns >> (exponente - BITS_SUBCUBETA)) & (SUBCUBETAS - 1);
+        return static_cast<std::size_t>(exponente - BITS_SUBCUBETA + 1) * SUBCUBETAS + sub;
+    }
+
+    // Mayor valor que cae en la cubeta
+    static std::uint64_t limiteSuperior(std::size_t cubeta) {
+        if (cubeta < SUBCUBETAS) return cubeta;
+        int desplazamiento = static_cast<int>(cubeta / SUBCUBETAS) - 1;
+        std::uint64_t base = (SUBCUBETAS + cubeta % SUBCUBETAS) << desplazamiento;
+        return base + ((std::uint64_t(1) << desplazamiento) - 1);
+    }
+
+public:
+    void registrar(std::uint64_t ns) {
+        cubetas[cubetaDe(ns)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sumaNs.fetch_add(ns, std::memory_order_relaxed);
+        std::uint64_t maximo = maximoNs.load(std::memory_order_relaxed);
+        while (ns > maximo &&
+               !maximoNs.compare_exchange_weak(maximo, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::uint64_t cantidad() const { return total.load(std::memory_order_relaxed); }
+    std::uint64_t maximo() const { return maximoNs.load(std::memory_order_relaxed); }
+    std::uint64_t promedio() const {
+        std::uint64_t n = cantidad();
+        return n > 0 ? sumaNs.load(std::memory_order_relaxed) / n : 0;
+    }
+
+    // Percentil p en [0, 1]: limite superior de la cubeta donde cae (0 sin muestras)
+    std::uint64_t percentil(double p) const;
+};
+
+class Metricas {
+private:
+    std::array<HistogramaLatencia, NUM_OPERACIONES_MEDIDAS> latencias;
+    std::array<std::array<std::atomic<std::uint64_t>, NUM_CODIGOS_RESULTADO>,
+               NUM_OPERACIONES_MEDIDAS> resultados{};
+    std::atomic<bool> activa{true};
+
+public:
+    // Con false se ignoran las mediciones (p. ej. mientras se reproduce el journal)
+    void setActiva(bool valor) { activa.store(valor, std::memory_order_relaxed); }
+
+    void registrarLatencia(OperacionMedida operacion, std::uint64_t ns) {
+        if (!activa.load(std::memory_order_relaxed)) return;
+        latencias[static_cast<std::size_t>(operacion)].registrar(ns);
+    }
+    void contarResultado(OperacionMedida operacion, CodigoResultado resultado,
+                         std::uint64_t veces = 1) {
+        if (!activa.load(std::memory_order_relaxed)) return;
+        resultados[static_cast<std::size_t>(operacion)][static_cast<std::size_t>(resultado)]
+            .fetch_add(veces, std::memory_order_relaxed);
+    }
+
+    const HistogramaLatencia& latencia(OperacionMedida operacion) const {
+        return latencias[static_cast<std::size_t>(operacion)];
+    }
+    std::uint64_t conteo(OperacionMedida operacion, CodigoResultado resultado) const {
+        return resultados[static_cast<std::size_t>(operacion)]
+                         [static_cast<std::size_t>(resultado)].load(std::memory_order_relaxed);
+    }
+
+    void mostrar() const;
+    // Objeto JSON con cantidad, promedio, p50/p90/p99/max (ns) y resultados por operacion
+    std::string aJson() const;
+};
+
+// Mide desde su construccion; al pasarle el resultado registra latencia y motivo
+class MedicionOperacion {
+private:
+    Metricas& metricas;
+    OperacionMedida operacion;
+    std::chrono::steady_clock::time_point inicio;
+
+public:
+    MedicionOperacion(Metricas& metricas, OperacionMedida operacion)
+        : metricas(metricas), operacion(operacion), inicio(std::chrono::steady_clock::now()) {}
+
+    CodigoResultado operator()(CodigoResultado resultado) {
+        metricas.registrarLatencia(operacion, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - inicio).count()));
+        metricas.contarResultado(operacion, resultado);
+        return resultado;
+    }
+};
+
+// Escribe metricas.aJson() en 'archivo' cada 'intervalo' (tmp + rename) desde un
+// hilo propio, y una ultima vez al destruirse
+class VolcadoMetricas {
+private:
+    const Metricas& metricas;
+    std::string archivo;
+    std::chrono::seconds intervalo;
+    std::mutex mutex;
+    std::condition_variable despertar;
+    bool detener;
+    std::thread hilo;  // ultimo: arranca con el resto ya construido
+
+    void ejecutar();
+    void volcar() const;
+
+public:
+    VolcadoMetricas(const Metricas& metricas, const std::string& archivo,
+                    std::chrono::seconds intervalo);
+    ~VolcadoMetricas();
+    VolcadoMetricas(const VolcadoMetricas&) = delete;
+    VolcadoMetricas& operator=(const VolcadoMetricas&) = delete;
+};
+
+// =================================================================================
+// ARCHIVO: CargaTexto.h
+// RESPONSABILIDAD: Analisis en paralelo del archivo de texto de guardarDatos
+// =================================================================================
+
+// El archivo mapeado se parte en trozos alineados a lineas y cada trozo se
+// analiza en su propio hilo con from_chars y vistas sobre el mapeo, sin copiar
+// campos. Gimnasio::cargarDatos fusiona despues los trozos en orden. Las lineas
+// que no se pueden interpretar quedan anotadas con su numero para informarlas.
+
+struct MiembroTexto {
+    std::string_view nombre;
+    int id;
+    TipoMembresia tipo;
+    bool activo;
+    int diasAsistencia;
+    std::uint32_t primerMomento;  // rango dentro de TrozoTexto::momentos
+    std::uint32_t numMomentos;
+    std::size_t linea;
+};
+
+struct ClaseTexto {
+    std::string_view nombre;
+    std::string_view instructor;
+    std::string_view horario;
+    std::string_view codigo;
+    int capacidad;
+    std::size_t linea;
+};
+
+struct FilaInscripcionTexto {
+    std::string_view codigo;
+    std::uint32_t primerId;  // rango dentro de TrozoTexto::idsInscritos
+    std::uint32_t numIds;
+};
+
+struct LineaMalformada {
+    std::size_t linea;  // 1 = primera linea del archivo
+    const char* motivo;
+};
+
+struct TrozoTexto {
+    const char* inicio;
+    const char* fin;
+    std::size_t primeraLinea = 0;  // indice (desde 0) de la linea en 'inicio'
+    std::size_t saltos = 0;        // '\n' dentro del trozo
+    std::vector<MiembroTexto> miembros;
+    std::vector<std::int64_t> momentos;  // historiales ya acumulados (no deltas)
+    std::vector<ClaseTexto> clases;
+    std::vector<FilaInscripcionTexto> inscripciones;
+    std::vector<std::int32_t> idsInscritos;
+    std::vector<LineaMalformada> malformadas;
+};
+
+struct TextoGimnasio {
+    static constexpr std::size_t MAX_LINEAS_REPORTADAS = 10;
+
+    std::size_t numMiembros = 0;
+    std::size_t numClases = 0;
+    std::size_t numAristas = 0;
+    std::vector<TrozoTexto> trozos;
+
+    void mostrarMalformadas() const;
+};
+
+// Analiza el contenido completo; false si las cabeceras de conteo no se pueden
+// leer (no es un archivo de datos del gimnasio). 'cantidadTrozos' = 0 reparte
+// segun hilos y tamanio; otro valor fija los cortes (pruebas de bordes).
+bool analizarTextoGimnasio(const char* datos, std::size_t largo, TextoGimnasio& texto,
+                           std::size_t cantidadTrozos = 0);
+
+// =================================================================================
+// ARCHIVO: Importacion.h
+// RESPONSABILIDAD: Alta masiva de miembros desde CSV con reporte compacto por fila
+// =================================================================================
+
+// Columnas por nombre en la cabecera: id, nombre, membresia y, opcional, activo
+// (1/0); el resto se ignora, asi sirve directo la salida de "--exportar miembros".
+// Sin cabecera (primer campo numerico) el orden es id,nombre,membresia[,activo].
+enum class MotivoRechazo : std::uint8_t {
+    FilaMalformada,      // comillas sin cerrar, columnas faltantes, nombre vacio
+    IdInvalido,
+    MembresiaInvalida,
+    IdRepetidoEnArchivo, // se queda la primera aparicion
+    IdYaRegistrado,
+    Cantidad
+};
+
+constexpr std::size_t NUM_MOTIVOS_RECHAZO = static_cast<std::size_t>(MotivoRechazo::Cantidad);
+const char* nombreMotivoRechazo(MotivoRechazo motivo);
+
+struct RechazoImportacion {
+    std::uint32_t linea;  // linea del CSV donde empieza la fila (1 = primera)
+    MotivoRechazo motivo;
+};
+
+struct ResultadoImportacion {
+    static constexpr std::size_t MAX_RECHAZOS_MOSTRADOS = 10;
+
+    bool cabeceraValida = true;
+    std::size_t filas = 0;
+    std::size_t importados = 0;
+    std::vector<RechazoImportacion> rechazos;  // ordenados por linea
+    std::array<std::size_t, NUM_MOTIVOS_RECHAZO> porMotivo{};
+
+    void rechazar(std::uint32_t linea, MotivoRechazo motivo) {
+        rechazos.push_back({linea, motivo});
+        porMotivo[static_cast<std::size_t>(motivo)]++;
+    }
+    void mostrar() const;
+};
+
+struct FilaImportacion {
+    std::string nombre;
+    int id;
+    TipoMembresia tipo;
+    bool activo;
+    std::uint32_t linea;
+};
+
+// Lee filas CSV (RFC 4180): campos entre comillas con "" escapado, que pueden
+// contener comas y saltos de linea. Los buffers de campo se reutilizan entre filas.
+class LectorCsv {
+private:
+    const char* actual;
+    const char* fin;
+    std::uint32_t linea;
+
+    void saltarLinea();
+
+public:
+    LectorCsv(const char* datos, std::size_t largo)
+        : actual(datos), fin(datos + largo), linea(1) {}
+
+    // Deja la fila en campos[0, cantidad); false al terminar la entrada.
+    // 'correcta' queda en false si la fila no respeta el formato.
+    bool siguienteFila(std::vector<std::string>& campos, std::size_t& cantidad,
+                       std::uint32_t& lineaFila, bool& correcta);
+};
+
+// Valida cada fila y devuelve las aceptadas en orden; false si la cabecera no
+// trae las columnas obligatorias
+bool analizarCsvMiembros(const char* datos, std::size_t largo,
+                         std::vector<FilaImportacion>& filas, ResultadoImportacion& resultado);
+// Deja solo la primera fila de cada ID (una pasada sobre las posiciones ordenadas)
+void descartarIdsRepetidos(std::vector<FilaImportacion>& filas, ResultadoImportacion& resultado);
+
+// =================================================================================
+// ARCHIVO: Gimnasio.h
+// RESPONSABILIDAD: Orquesta todas las operaciones del gimnasio
+// =================================================================================
+
+// Foto O(1) de los contadores del dia, pensada para consultarse continuamente
+struct ResumenDiario {
+    std::size_t miembros;
+    std::size_t clases;
+    std::int64_t asistenciasHoy;
+    std::int64_t asistenciasAyer;
+    std::int64_t cuposOcupados;
+    std::int64_t cuposTotales;
+};
+
+// Miembros / activos / asistencias por tipo, en el orden del enum
+using ResumenPorMembresia =
+    std::array<ResumenColumnas, static_cast<std::size_t>(TipoMembresia::Cantidad)>;
+
+// Concurrencia (varias recepciones y torniquetes sobre el mismo Gimnasio):
+//  - mutexEstructura: exclusivo para altas de miembros/clases, cargas, reportes y
+//    snapshots; compartido para todas las operaciones sobre entidades existentes.
+//  - shards de miembros: un mutex por grupo de IDs protege estado, asistencias y
+//    clases inscritas del miembro (y con ello el limite por membresia).
+//  - franjas de clases: un mutex por grupo de IdClase protege el roster y el cupo.
+// Orden de adquisicion: estructura -> shard de miembro -> franja de clase -> journal.
+// Cada operacion toma a lo sumo un shard y una franja, asi no hay ciclos.
+constexpr std::size_t NUM_SHARDS_MIEMBROS = 64;
+constexpr std::size_t NUM_FRANJAS_CLASES = 64;
+
+class Gimnasio {
+private:
+    std::string nombre;
+    RegistroIndexado<int, Miembro> miembros;
+    RegistroIndexado<std::string, ClaseGym> clases;
+    ColumnasMiembros columnas;  // vista columnar, mismo slot que 'miembros'
+    IndicePrefijos indiceNombres;            // typeahead por nombre de miembro
+    IndiceInstructores indiceInstructores;   // instructor -> clases
+    ContadorDiario asistenciasPorDia;
+    LineaTiempoSemanal lineaTiempo;  // franjas de todas las clases con horario estructurado
+    AsistenciasPorHora asistenciasPorHora;
+    std::atomic<std::int64_t> cuposOcupados;  // suma de inscritos de todas las clases
+    std::atomic<std::int64_t> cuposTotales;   // suma de capacidades
+    std::unique_ptr<Journal> journal;
+    mutable Metricas metricas;  // contadores atomicos: se actualizan tambien desde const
+    std::uint64_t secuenciaAplicada;  // ultima operacion del journal ya aplicada
+    std::uint64_t secuenciaSnapshot;  // ultima incluida en un snapshot (bajo mutexJournal)
+    std::uint64_t generacion;  // cambia cada vez que se vacia el registro al cargar
+
+    mutable std::shared_mutex mutexEstructura;
+    mutable std::array<std::mutex, NUM_SHARDS_MIEMBROS> mutexShards;
+    mutable std::array<std::mutex, NUM_FRANJAS_CLASES> mutexFranjas;
+    mutable std::mutex mutexJournal;
+    mutable std::mutex mutexSnapshot;  // un snapshot a la vez (mismo archivo temporal)
+
+    struct BloqueoMiembro {
+        std::shared_lock<std::shared_mutex> estructura;
+        std::unique_lock<std::mutex> shard;
+    };
+    std::mutex& mutexShard(int idMiembro) const {
+        return mutexShards[static_cast<std::uint32_t>(idMiembro) % NUM_SHARDS_MIEMBROS];
+    }
+    std::mutex& mutexFranja(IdClase idClase) const {
+        return mutexFranjas[idClase % NUM_FRANJAS_CLASES];
+    }
+    BloqueoMiembro bloquearMiembro(int idMiembro) const {
+        std::shared_lock<std::shared_mutex> estructura(mutexEstructura);
+        return BloqueoMiembro{std::move(estructura),
+                              std::unique_lock<std::mutex>(mutexShard(idMiembro))};
+    }
+
+    void anotar(TipoRegistro tipo, const EscritorRegistro& registro);
+    void aplicarRegistro(TipoRegistro tipo, LectorRegistro& lector);
+
+    // Inscripcion/cancelacion sin promover la lista de espera (la reproduccion del
+    // journal usa estas: las promociones vienen en sus propios registros).
+    // 'idClase' recibe la clase resuelta bajo el bloqueo (HANDLE_INVALIDO si no existe).
+    CodigoResultado aplicarInscripcion(int idMiembro, const std::string& codigoClase,
+                                       IdClase& idClase);
+    CodigoResultado aplicarCancelacion(int idMiembro, const std::string& codigoClase,
+                                       IdClase& idClase);
+    // Saca a idMiembro de la lista de espera y lo inscribe si aun califica
+    void aplicarPromocion(int idMiembro, IdClase idClase);
+    // Llena los cupos libres de la clase con la lista de espera; devuelve cuantos entraron
+    int promoverListaEspera(IdClase idClase);
+    // Filas que una exportacion copia por cada toma del bloqueo compartido
+    static constexpr std::size_t FILAS_POR_TANDA = 4096;
+    // Copia lo que se muestra de cada clase (bajo su franja) para formatearlo sin bloqueos
+    std::vector<FilaClase> capturarClases(const std::vector<IdClase>& ids) const;
+    // Copia de las columnas leyendo cada fila bajo su shard; requiere mutexEstructura
+    ColumnasMiembros copiarColumnas() const;
+    // Copia del estado para un snapshot; toma los bloqueos por su cuenta.
+    // 'alCerrar' corre todavia con la estructura exclusiva, en el punto exacto
+    // que refleja la captura.
+    CapturaSnapshot capturarSnapshot(const std::function<void()>& alCerrar = {}) const;
+    void reconstruirAgregados();
+
+    // Reparte ambos sentidos del grafo en rosters y listas de clases, reservando
+    // cada contenedor una sola vez. Los nodos se traducen con los mapas a handles.
+    void cargarInscripciones(const GrafoCSR& porClase, const GrafoCSR& porMiembro,
+                             const std::vector<Handle>& handleMiembro,
+                             const std::vector<Handle>& handleClase);
+
+    // Métodos auxiliares privados
+    // Los punteros devueltos solo son validos hasta el proximo registro/creacion;
+    // para referencias duraderas usar los handles.
+    Miembro* buscarMiembroPorId(int idMiembro);
+    ClaseGym* buscarClasePorCodigo(const std::string& codigo);
+
+public:
+    Gimnasio(const std::string& nombre);
+    const std::string& getNombre() const { return nombre; }
+    const Metricas& getMetricas() const { return metricas; }
+
+    // Operaciones sin salida por consola, seguras entre hilos; registran en el
+    // journal si tienen exito
+    CodigoResultado ejecutarRegistroMiembro(const std::string& nombre, int idMiembro,
+                                            TipoMembresia tipoMembresia);
+    CodigoResultado ejecutarCreacionClase(const std::string& nombre,
+                                          const std::string& instructor,
+                                          const std::string& horario,
+                                          const std::string& codigo, int capacidad);
+    CodigoResultado ejecutarAsistencia(int idMiembro, std::int64_t momento = momentoActual());
+    int ejecutarAsistenciasLote(const int* ids, std::size_t cantidad,
+                                CodigoResultado* resultados,
+                                std::int64_t momento = momentoActual());
+    // Con la clase llena (o con gente esperando) el miembro queda en la lista de
+    // espera: EnListaEspera; si ya estaba en ella, ClaseLlena. Cancelar a alguien
+    // en espera lo saca de la lista.
+    CodigoResultado ejecutarInscripcion(int idMiembro, const std::string& codigoClase);
+    CodigoResultado ejecutarCancelacion(int idMiembro, const std::string& codigoClase);
+    CodigoResultado ejecutarCambioEstado(int idMiembro, bool activa);
+    // Alta masiva desde CSV (ver Importacion.h) bajo un solo bloqueo; las filas
+    // rechazadas vuelven en el resultado, sin salida por consola
+    ResultadoImportacion importarMiembros(const char* datos, std::size_t largo);
+
+    // Búsqueda indexada (O(1) promedio) con handles estables.
+    // Acceso directo sin bloqueo: solo para uso de un solo hilo.
+    Handle buscarHandleMiembro(int idMiembro) const { return miembros.buscar(idMiembro); }
+    Handle buscarHandleClase(const std::string& codigo) const { return clases.buscar(codigo); }
+    Miembro& getMiembro(Handle h) { return miembros.obtener(h); }
+    const Miembro& getMiembro(Handle h) const { return miembros.obtener(h); }
+    ClaseGym& getClase(Handle h) { return clases.obtener(h); }
+    const ClaseGym& getClase(Handle h) const { return clases.obtener(h); }
+
+    // Gestión de miembros
+    void registrarMiembro(const std::string& nombre, int idMiembro, 
+                         const std::string& tipoMembresia);
+    void mostrarMiembros() const;
+    void suspenderMembresia(int idMiembro);
+    void reactivarMembresia(int idMiembro);
+
+    // Gestión de clases
+    void crearClase(const std::string& nombre, const std::string& instructor,
+                   const std::string& horario, const std::string& codigo, 
+                   int capacidad);
+    void mostrarHorarioClases() const;
+    // Clases que se dictan en algun momento de la ventana (sin repetir)
+    std::vector<IdClase> clasesEntre(const IntervaloSemanal& ventana) const;
+    void mostrarClasesEnHorario(const std::string& consulta) const;
+
+    // Busquedas por indice secundario, sin distinguir mayusculas ni acentos.
+    // Miembros con alguna palabra del nombre que empieza con 'prefijo', ordenados
+    // por nombre; a lo sumo 'limite'.
+    std::vector<Handle> buscarMiembrosPorPrefijo(const std::string& prefijo,
+                                                 std::size_t limite = 20) const;
+    std::vector<IdClase> clasesDeInstructor(const std::string& instructor) const;
+    void mostrarBusquedaMiembros(const std::string& prefijo) const;
+    void mostrarClasesDeInstructor(const std::string& instructor) const;
+
+    // Operaciones principales
+    void registrarAsistencia(int idMiembro);
+    // Lote de torniquete: sin salida por consola; resultados[i] corresponde a ids[i].
+    // Devuelve cuantas asistencias se registraron.
+    int registrarAsistenciasLote(const int* ids, std::size_t cantidad,
+                                 CodigoResultado* resultados);
+    void inscribirMiembroAClase(int idMiembro, const std::string& codigoClase);
+    void cancelarInscripcionClase(int idMiembro, const std::string& codigoClase);
+
+    // Historial de asistencias: rango [desde, hasta) en segundos desde epoch
+    CodigoResultado contarAsistenciasMiembro(int idMiembro, std::int64_t desde,
+                                             std::int64_t hasta, std::size_t& total) const;
+    std::vector<std::uint32_t> asistenciasPorHoraEntre(std::int64_t desde,
+                                                       std::int64_t hasta) const;
+    void mostrarHistorialAsistencias(int idMiembro) const;
+
+    // Listados en streaming: desde el slot 'cursor', hasta 'limite' registros que
+    // pasan el filtro. Devuelven el cursor de la pagina siguiente (HANDLE_INVALIDO
+    // si no quedan). CSV escribe la cabecera solo en la primera pagina; cada
+    // pagina JSON es un objeto completo con su cursor "siguiente".
+    Handle exportarMiembros(SalidaBuffer& salida, const FiltroMiembros& filtro,
+                            FormatoExportacion formato, Handle cursor = 0,
+                            std::size_t limite = std::numeric_limits<std::size_t>::max()) const;
+    Handle exportarClases(SalidaBuffer& salida, const FiltroClases& filtro,
+                          FormatoExportacion formato, Handle cursor = 0,
+                          std::size_t limite = std::numeric_limits<std::size_t>::max()) const;
+
+    // Reportes
+    ResumenDiario obtenerResumenDiario() const;
+    ResumenPorMembresia obtenerResumenPorMembresia() const;
+    std::vector<int> idsMiembros() const;
+    void mostrarResumenDiario() const;
+    void mostrarReporteAnalitico() const;
+
+    // Persistencia de datos
+    // Con informar=false las cargas no anuncian el resumen (avisos y errores si)
+    void guardarDatos(const std::string& archivo);
+    void cargarDatos(const std::string& archivo, bool informar = true);
+    bool guardarSnapshot(const std::string& archivo) const;
+    bool cargarSnapshot(const std::string& archivo, bool informar = true);
+    // Lo que guardarDatos/guardarSnapshot escriben, sin tocar disco ni consola
+    std::string imagenDatos() const;
+    std::string imagenSnapshot() const;
+
+    // Journal: se reproduce sobre el estado cargado y luego queda abierto para agregar
+    bool activarJournal(const std::string& ruta, const ConfigJournal& config = ConfigJournal());
+    void confirmarCambios();
+    // Captura el estado bajo el bloqueo exclusivo (solo copia en memoria) y lo
+    // escribe fuera de el: las operaciones siguen mientras se escribe el archivo.
+    // 'informar' = false no imprime nada salvo errores (guardado automatico).
+    bool checkpoint(const std::string& archivoSnapshot, bool informar = true);
+    // Operaciones anotadas en el journal que aun no estan en un snapshot
+    std::uint64_t cambiosSinSnapshot() const;
+};
+
+// =================================================================================
+// ARCHIVO: Exportacion.cpp
+// =================================================================================
+
+SalidaBuffer::SalidaBuffer(int fd, std::size_t capacidad)
+    : fd(fd), propio(false), correcto(fd >= 0), buffer(std::max<std::size_t>(capacidad, 64)),
+      usado(0) {}
+
+SalidaBuffer::~SalidaBuffer() {
+    vaciar();
+    if (propio) ::close(fd);
+}
+
+bool SalidaBuffer::abrir(const std::string& ruta) {
+    vaciar();
+    if (propio) ::close(fd);
+    fd = ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    propio = fd >= 0;
+    correcto = fd >= 0;
+    return correcto;
+}
+
+void SalidaBuffer::vaciar() {
+    // Lo que haya en cout debe salir antes que este buffer
+    if (fd == STDOUT_FILENO) std::cout.flush();
+    const char* p = buffer.data();
+    std::size_t restante = usado;
+    while (restante > 0 && correcto) {
+        ssize_t n = ::write(fd, p, restante);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            correcto = false;
+            break;
+        }
+        p += n;
+        restante -= static_cast<std::size_t>(n);
+    }
+    usado = 0;
+}
+
+void SalidaBuffer::escribir(const char* datos, std::size_t largo) {
+    if (largo > buffer.size()) {
+        vaciar();
+        buffer.resize(largo);
+    }
+    reservar(largo);
+    std::memcpy(buffer.data() + usado, datos, largo);
+    usado += largo;
+}
+
+void SalidaBuffer::campoCsv(const std::string& texto) {
+    if (texto.find_first_of(",\"\n\r") == std::string::npos) {
+        *this << texto;
+        return;
+    }
+    *this << '"';
+    for (char c : texto) {
+        if (c == '"') *this << '"';
+        *this << c;
+    }
+    *this << '"';
+}
+
+void SalidaBuffer::cadenaJson(const std::string& texto) {
+    *this << '"';
+    for (char c : texto) {
+        switch (c) {
+            case '"': *this << "\\\""; break;
+            case '\\': *this << "\\\\"; break;
+            case '\n': *this << "\\n"; break;
+            case '\r': *this << "\\r"; break;
+            case '\t': *this << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    *this << escape;
+                } else {
+                    *this << c;
+                }
+        }
+    }
+    *this << '"';
+}
+
+bool parsearConfigExportacion(int argc, char* argv[], ConfigExportacion& config) {
+    if (argc < 3) return false;
+    std::string entidad = argv[2];
+    if (entidad != "miembros" && entidad != "clases") return false;
+    config.clases = entidad == "clases";
+
+    for (int i = 3; i < argc; i++) {
+        std::string opcion = argv[i];
+        if (opcion == "--con-cupo") {
+            config.filtroClases.soloConCupo = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        std::string valor = argv[++i];
+        try {
+            if (opcion == "--formato") {
+                if (valor == "texto") config.formato = FormatoExportacion::Texto;
+                else if (valor == "csv") config.formato = FormatoExportacion::Csv;
+                else if (valor == "json") config.formato = FormatoExportacion::Json;
+                else return false;
+            } else if (opcion == "--membresia") {
+                TipoMembresia tipo;
+                if (!parsearTipoMembresia(valor, tipo)) return false;
+                config.filtroMiembros.tipoMembresia = static_cast<int>(tipo);
+            } else if (opcion == "--activos") {
+                config.filtroMiembros.activo = std::stoi(valor) != 0 ? 1 : 0;
+            } else if (opcion == "--min-asistencias") {
+                config.filtroMiembros.minAsistencias = std::stoi(valor);
+            } else if (opcion == "--instructor") {
+                config.filtroClases.instructor = valor;
+            } else if (opcion == "--desde") {
+                config.cursor = static_cast<Handle>(std::stoul(valor));
+            } else if (opcion == "--limite") {
+                config.limite = std::stoul(valor);
+            } else if (opcion == "--salida") {
+                config.salida = valor;
+            } else {
+                return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// =================================================================================
+// ARCHIVO: Horario.cpp
+// =================================================================================
+
+namespace {
+
+// Dia de la semana (0 = lunes) por nombre corto o largo, con o sin tilde
+bool parsearDia(std::string texto, int& dia) {
+    static const char* const NOMBRES[][4] = {
+        {"lun", "lunes", "", ""},
+        {"mar", "martes", "", ""},
+        {"mie", "miercoles", "mié", "miércoles"},
+        {"jue", "jueves", "", ""},
+        {"vie", "viernes", "", ""},
+        {"sab", "sabado", "sáb", "sábado"},
+        {"dom", "domingo", "", ""},
+    };
+    for (char& c : texto) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    for (int d = 0; d < 7; d++) {
+        for (const char* nombre : NOMBRES[d]) {
+            if (*nombre != '\0' && texto == nombre) {
+                dia = d;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// "HH:MM" (o "H:MM") a minutos; acepta 24:00 como fin de dia
+bool parsearHora(const std::string& texto, int& minutos) {
+    int horas = 0, mins = 0;
+    std::size_t dosPuntos = texto.find(':');
+    if (dosPuntos == std::string::npos || dosPuntos == 0 || texto.size() - dosPuntos != 3) {
+        return false;
+    }
+    auto r1 = std::from_chars(texto.data(), texto.data() + dosPuntos, horas);
+    auto r2 = std::from_chars(texto.data() + dosPuntos + 1, texto.data() + texto.size(), mins);
+    if (r1.ec != std::errc() || r1.ptr != texto.data() + dosPuntos ||
+        r2.ec != std::errc() || r2.ptr != texto.data() + texto.size()) {
+        return false;
+    }
+    minutos = horas * 60 + mins;
+    return horas >= 0 && mins >= 0 && mins < 60 && minutos <= MINUTOS_DIA;
+}
+
+bool parsearTramo(const std::string& tramo, std::vector<IntervaloSemanal>& intervalos) {
+    std::stringstream ss(tramo);
+    std::string dias, horas, sobrante;
+    if (!(ss >> dias >> horas) || (ss >> sobrante)) return false;
+
+    std::size_t guion = horas.find('-');
+    int inicio, fin;
+    if (guion == std::string::npos || !parsearHora(horas.substr(0, guion), inicio) ||
+        !parsearHora(horas.substr(guion + 1), fin) || inicio == fin) {
+        return false;
+    }
+    if (fin < inicio) fin += MINUTOS_DIA;  // pasa la medianoche
+
+    std::stringstream lista(dias);
+    std::string parte;
+    while (std::getline(lista, parte, ',')) {
+        std::size_t rango = parte.find('-');
+        int primero, ultimo;
+        if (rango == std::string::npos) {
+            if (!parsearDia(parte, primero)) return false;
+            ultimo = primero;
+        } else if (!parsearDia(parte.substr(0, rango), primero) ||
+                   !parsearDia(parte.substr(rango + 1), ultimo)) {
+            return false;
+        }
+        for (int d = primero;; d = (d + 1) % 7) {
+            int a = d * MINUTOS_DIA + inicio;
+            int b = d * MINUTOS_DIA + fin;
+            if (b <= MINUTOS_SEMANA) {
+                intervalos.push_back({a, b});
+            } else {
+                intervalos.push_back({a, MINUTOS_SEMANA});
+                intervalos.push_back({0, b - MINUTOS_SEMANA});
+            }
+            if (d == ultimo) break;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool parsearHorario(const std::string& texto, std::vector<IntervaloSemanal>& intervalos) {
+    std::vector<IntervaloSemanal> resultado;
+    std::stringstream ss(texto);
+    std::string tramo;
+    while (std::getline(ss, tramo, ';')) {
+        if (tramo.find_first_not_of(" \t") == std::string::npos) continue;
+        if (!parsearTramo(tramo, resultado)) return false;
+    }
+    if (resultado.empty()) return false;
+
+    // Ordenar y fusionar solapes: la agenda del miembro asume intervalos disjuntos
+    std::sort(resultado.begin(), resultado.end(),
+              [](const IntervaloSemanal& a, const IntervaloSemanal& b) { return a.inicio < b.inicio; });
+    intervalos.clear();
+    for (const IntervaloSemanal& intervalo : resultado) {
+        if (!intervalos.empty() && intervalo.inicio <= intervalos.back().fin) {
+            intervalos.back().fin = std::max(intervalos.back().fin, intervalo.fin);
+        } else {
+            intervalos.push_back(intervalo);
+        }
+    }
+    return true;
+}
+
+// =================================================================================
+// ARCHIVO: IndiceNombres.cpp
+// =================================================================================
+
+void normalizarTexto(std::string_view texto, std::string& destino) {
+    // Segundo byte de los caracteres latinos C3 80..BF; '*' = se deja tal cual
+    static const char LATINOS[] = "aaaaaaaceeeeiiiidnooooo*ouuuuyts"
+                                  "aaaaaaaceeeeiiiidnooooo*ouuuuyty";
+    destino.clear();
+    bool espacio = false;
+    for (std::size_t i = 0; i < texto.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(texto[i]);
+        if (c == ' ' || c == '\t') {
+            espacio = !destino.empty();
+            continue;
+        }
+        if (espacio) {
+            destino += ' ';
+            espacio = false;
+        }
+        if (c == 0xC3 && i + 1 < texto.size()) {
+            unsigned char siguiente = static_cast<unsigned char>(texto[i + 1]);
+            if (siguiente >= 0x80 && siguiente <= 0xBF && LATINOS[siguiente - 0x80] != '*') {
+                destino += LATINOS[siguiente - 0x80];
+                i++;
+                continue;
+            }
+        }
+        destino += static_cast<char>(std::tolower(c));
+    }
+}
+
+void IndicePrefijos::anotar(std::string_view nombre, Handle h, std::vector<Entrada>& destino) {
+    normalizarTexto(nombre, normalizado);
+    const std::uint32_t base = static_cast<std::uint32_t>(claves.size());
+    const std::uint32_t largo = static_cast<std::uint32_t>(normalizado.size());
+    claves += normalizado;
+    for (std::uint32_t i = 0; i < largo; i++) {
+        if (i == 0 || normalizado[i - 1] == ' ') {
+            destino.push_back({base + i, largo - i, h});
+        }
+    }
+}
+
+void IndicePrefijos::agregar(std::string_view nombre, Handle h) {
+    const std::size_t antes = recientes.size();
+    anotar(nombre, h, recientes);
+    // Insercion ordenada de las entradas nuevas dentro del tramo chico
+    for (std::size_t i = antes; i < recientes.size(); i++) {
+        Entrada nueva = recientes[i];
+        auto destino = std::upper_bound(recientes.begin(), recientes.begin() + i, nueva,
+                                        [this](const Entrada& a, const Entrada& b) {
+                                            return menor(a, b);
+                                        });
+        std::move_backward(destino, recientes.begin() + i, recientes.begin() + i + 1);
+        *destino = nueva;
+    }
+    if (recientes.size() > MAX_RECIENTES) ordenar();
+}
+
+void IndicePrefijos::ordenar() {
+    auto porClave = [this](const Entrada& a, const Entrada& b) { return menor(a, b); };
+    principal.insert(principal.end(), recientes.begin(), recientes.end());
+    recientes.clear();
+    auto medio = principal.begin() + principalOrdenado;
+    std::sort(medio, principal.end(), porClave);
+    std::inplace_merge(principal.begin(), medio, principal.end(), porClave);
+    principalOrdenado = principal.size();
+}
+
+void IndicePrefijos::clear() {
+    claves.clear();
+    principal.clear();
+    recientes.clear();
+    principalOrdenado = 0;
+}
+
+// =================================================================================
+// ARCHIVO: Memoria.cpp
+// =================================================================================
+
+#ifdef GIMNASIO_CONTAR_ASIGNACIONES
+// Reemplazo de los operadores globales: cuentan y delegan en malloc/free (o
+// aligned_alloc). Se reemplazan todas las variantes, asi ninguna asignacion
+// de la biblioteca se escapa del conteo ni se libera con el operador equivocado.
+// Contadores relajados: solo se necesitan totales, no orden entre hilos.
+namespace {
+std::atomic<std::uint64_t> totalAsignaciones{0};
+std::atomic<std::uint64_t> totalBytesAsignados{0};
+
+void* asignarContado(std::size_t tam, std::size_t alineacion = 0) noexcept {
+    totalAsignaciones.fetch_add(1, std::memory_order_relaxed);
+    totalBytesAsignados.fetch_add(tam, std::memory_order_relaxed);
+    if (tam == 0) tam = 1;
+    if (alineacion <= alignof(std::max_align_t)) return std::malloc(tam);
+    // aligned_alloc pide un tamano multiplo de la alineacion
+    return std::aligned_alloc(alineacion, (tam + alineacion - 1) / alineacion * alineacion);
+}
+
+void* asignarOLanzar(std::size_t tam, std::size_t alineacion = 0) {
+    if (void* p = asignarContado(tam, alineacion)) return p;
+    throw std::bad_alloc();
+}
+}  // namespace
+
+void* operator new(std::size_t tam) { return asignarOLanzar(tam); }
+void* operator new[](std::size_t tam) { return asignarOLanzar(tam); }
+void* operator new(std::size_t tam, const std::nothrow_t&) noexcept {
+    return asignarContado(tam);
+}
+void* operator new[](std::size_t tam, const std::nothrow_t&) noexcept {
+    return asignarContado(tam);
+}
+void* operator new(std::size_t tam, std::align_val_t a) {
+    return asignarOLanzar(tam, static_cast<std::size_t>(a));
+}
+void* operator new[](std::size_t tam, std::align_val_t a) {
+    return asignarOLanzar(tam, static_cast<std::size_t>(a));
+}
+void* operator new(std::size_t tam, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return asignarContado(tam, static_cast<std::size_t>(a));
+}
+void* operator new[](std::size_t tam, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return asignarContado(tam, static_cast<std::size_t>(a));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+EstadisticasMemoria estadisticasMemoria() {
+    return {totalAsignaciones.load(std::memory_order_relaxed),
+            totalBytesAsignados.load(std::memory_order_relaxed)};
+}
+#else
+EstadisticasMemoria estadisticasMemoria() { return {0, 0}; }
+#endif
+
+std::ostream& operator<<(std::ostream& os, const EstadisticasMemoria& e) {
+    if (!CONTEO_ASIGNACIONES) return os << "sin conteo de asignaciones";
+    std::ostringstream texto;
+    texto << e.asignaciones << " asignaciones, " << std::fixed << std::setprecision(1)
+          << e.bytes / (1024.0 * 1024.0) << " MB";
+    return os << texto.str();
+}
+
+// =================================================================================
+// ARCHIVO: ClaseGym.cpp
+// =================================================================================
+
+ClaseGym::ClaseGym(const std::string& nombre, const std::string& instructor,
+                   const std::string& horario, const std::string& codigo, int capacidad)
+    : nombreClase(nombre), instructor(instructor), horario(horario),
+      codigoClase(codigo), capacidadMaxima(capacidad) {
+    parsearHorario(horario, intervalos);
+}
+
+bool ClaseGym::inscribirMiembro(int idMiembro) {
+    if (!tieneCupo()) {
+        return false;
+    }
+    return idsMiembrosInscritos.insertar(idMiembro);
+}
+
+bool ClaseGym::cancelarInscripcion(int idMiembro) {
+    return idsMiembrosInscritos.eliminar(idMiembro);
+}
+
+bool ClaseGym::estaMiembroInscrito(int idMiembro) const {
+    return idsMiembrosInscritos.contiene(idMiembro);
+}
+
+void FilaClase::escribirInformacion(SalidaBuffer& salida) const {
+    salida << " - Codigo: " << codigo << "\n"
+           << "   Clase: " << nombre << "\n"
+           << "   Instructor: " << instructor << "\n"
+           << "   Horario: " << horario << "\n"
+           << "   Cupos: " << inscritos << "/" << capacidad
+           << " (" << (inscritos < capacidad ? "Disponible" : "LLENO") << ")\n";
+    if (enEspera > 0) {
+        salida << "   En lista de espera: " << enEspera << "\n";
+    }
+}
+
+FilaClase ClaseGym::capturarFila() const {
+    return {codigoClase, nombreClase, instructor, horario,
+            getInscritos(), capacidadMaxima, listaEspera.size()};
+}
+
+void ClaseGym::escribirInformacion(SalidaBuffer& salida) const {
+    capturarFila().escribirInformacion(salida);
+}
+
+void ClaseGym::mostrarInformacion() const {
+    SalidaBuffer salida(STDOUT_FILENO, 1024);
+    escribirInformacion(salida);
+}
+
+// =================================================================================
+// ARCHIVO: Miembro.cpp
+// =================================================================================
+
+Miembro::Miembro(const std::string& nombre, int idMiembro, TipoMembresia tipoMembresia)
+    : nombre(nombre), idMiembro(idMiembro), tipoMembresia(tipoMembresia),
+      membresiaActiva(true), diasAsistencia(0), version(0) {}
+
+void Miembro::registrarAsistencia(std::int64_t momento) {
+    diasAsistencia++;
+    historial.agregar(momento);
+    version++;
+}
+
+void Miembro::sumarAsistencias(int cantidad, std::int64_t momento) {
+    diasAsistencia += cantidad;
+    historial.agregar(momento, static_cast<std::uint32_t>(cantidad));
+    version++;
+}
+
+void Miembro::inscribirseAClase(IdClase clase, const std::vector<IntervaloSemanal>& intervalos) {
+    clasesInscritas.push_back(clase);
+    agenda.agregar(clase, intervalos);
+    version++;
+}
+
+void Miembro::cancelarClase(IdClase clase) {
+    // El orden no importa: se intercambia con el ultimo para no desplazar el resto
+    auto it = std::find(clasesInscritas.begin(), clasesInscritas.end(), clase);
+    if (it != clasesInscritas.end()) {
+        *it = clasesInscritas.back();
+        clasesInscritas.pop_back();
+        agenda.quitar(clase);
+        version++;
+    }
+}
+
+void FilaMiembro::escribirInformacion(SalidaBuffer& salida) const {
+    salida << " - ID: " << idMiembro << "\n"
+           << "   Nombre: " << nombre << "\n"
+           << "   Membresia: " << getNombreMembresia() << "\n"
+           << "   Estado: " << (activo ? "ACTIVA" : "INACTIVA") << "\n"
+           << "   Asistencias: " << diasAsistencia << " dias ("
+           << asistenciasRecientes << " en los ultimos 30)\n"
+           << "   Clases inscritas: " << clasesInscritas << "\n";
+}
+
+FilaMiembro Miembro::capturarFila(std::int64_t ahora) const {
+    return {idMiembro, nombre, tipoMembresia, membresiaActiva, diasAsistencia,
+            historial.contarEntre(ahora - 30 * 86400, ahora + 1), getCantidadClasesInscritas()};
+}
+
+void Miembro::escribirInformacion(SalidaBuffer& salida, std::int64_t ahora) const {
+    capturarFila(ahora).escribirInformacion(salida);
+}
+
+void Miembro::mostrarInformacion() const {
+    SalidaBuffer salida(STDOUT_FILENO, 1024);
+    escribirInformacion(salida, momentoActual());
+}
+
+// =================================================================================
+// ARCHIVO: Journal.cpp
+// =================================================================================
+
+std::uint32_t checksumFnv1a(const char* datos, std::size_t largo) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < largo; i++) {
+        hash ^= static_cast<std::uint8_t>(datos[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+Journal::Journal()
+    : fd(-1), registrosPendientes(0), lotesSinFsync(0), ultimaSecuencia(0) {}
+
+Journal::~Journal() {
+    if (fd >= 0) {
+        sincronizar();
+        ::close(fd);
+    }
+}
+
+bool Journal::abrir(const std::string& ruta, const ConfigJournal& cfg,
+                    std::uint64_t secuenciaInicial) {
+    fd = ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    this->ruta = ruta;
+    config = cfg;
+    ultimaSecuencia = secuenciaInicial;
+    return fd >= 0;
+}
+
+std::uint64_t Journal::agregar(TipoRegistro tipo, const std::string& payload) {
+    std::uint64_t secuencia = ++ultimaSecuencia;
+    std::uint32_t largo = static_cast<std::uint32_t>(payload.size());
+    std::uint8_t codigoTipo = static_cast<std::uint8_t>(tipo);
+
+    std::size_t inicio = pendiente.size();
+    pendiente.append(reinterpret_cast<const char*>(&largo), sizeof(largo));
+    pendiente.append(reinterpret_cast<const char*>(&secuencia), sizeof(secuencia));
+    pendiente.append(reinterpret_cast<const char*>(&codigoTipo), sizeof(codigoTipo));
+    pendiente += payload;
+    std::uint32_t checksum = checksumFnv1a(pendiente.data() + inicio + sizeof(largo),
+                                           pendiente.size() - inicio - sizeof(largo));
+    pendiente.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+    if (++registrosPendientes >= config.registrosPorLote) {
+        confirmar();
+    }
+    return secuencia;
+}
+
+void Journal::escribirPendiente() {
+    const char* p = pendiente.data();
+    std::size_t restante = pendiente.size();
+    while (restante > 0) {
+        ssize_t n = ::write(fd, p, restante);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cout << "ERROR: Fallo la escritura del journal.\n";
+            break;
+        }
+        p += n;
+        restante -= static_cast<std::size_t>(n);
+    }
+    pendiente.clear();
+    registrosPendientes = 0;
+}
+
+void Journal::confirmar() {
+    if (fd < 0 || pendiente.empty()) return;
+    escribirPendiente();
+    if (config.lotesPorFsync > 0 && ++lotesSinFsync >= config.lotesPorFsync) {
+        ::fsync(fd);
+        lotesSinFsync = 0;
+    }
+}
+
+void Journal::sincronizar() {
+    if (fd < 0) return;
+    if (!pendiente.empty()) escribirPendiente();
+    ::fsync(fd);
+    lotesSinFsync = 0;
+}
+
+int Journal::rotar() {
+    if (fd < 0) return -1;
+    const std::string anterior = rutaAnterior(ruta);
+    if (::access(anterior.c_str(), F_OK) == 0) return -1;
+    if (!pendiente.empty()) escribirPendiente();
+    if (::rename(ruta.c_str(), anterior.c_str()) != 0) return -1;
+    int nuevo = ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (nuevo < 0) {
+        ::rename(anterior.c_str(), ruta.c_str());  // se sigue en el mismo segmento
+        return -1;
+    }
+    int viejo = fd;
+    fd = nuevo;
+    lotesSinFsync = 0;
+    return viejo;
+}
+
+// =================================================================================
+// ARCHIVO: Metricas.cpp
+// =================================================================================
+
+const char* nombreOperacion(OperacionMedida operacion) {
+    static const char* const NOMBRES[] = {
+        "RegistroMiembro", "CreacionClase", "Asistencia", "AsistenciaLote", "Inscripcion",
+        "Cancelacion", "CambioEstado", "Consulta", "Listado", "Guardado", "Carga",
+        "Importacion"
+    };
+    static_assert(sizeof(NOMBRES) / sizeof(NOMBRES[0]) == NUM_OPERACIONES_MEDIDAS,
+                  "Cada OperacionMedida necesita su nombre");
+    return NOMBRES[static_cast<std::size_t>(operacion)];
+}
+
+std::uint64_t HistogramaLatencia::percentil(double p) const {
+    const std::uint64_t n = cantidad();
+    if (n == 0) return 0;
+    const std::uint64_t objetivo =
+        std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(p * n)));
+    std::uint64_t acumulado = 0;
+    for (std::size_t c = 0; c < NUM_CUBETAS; c++) {
+        acumulado += cubetas[c].load(std::memory_order_relaxed);
+        if (acumulado >= objetivo) return std::min(limiteSuperior(c), maximo());
+    }
+    return maximo();
+}
+
+void Metricas::mostrar() const {
+    std::cout << "\n**************** ESTADISTICAS DE OPERACIONES ****************\n"
+              << std::left << std::setw(16) << "Operacion" << std::right
+              << std::setw(10) << "Cantidad" << std::setw(11) << "Prom (us)"
+              << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+              << std::setw(11) << "Max (us)" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    auto us = [](std::uint64_t ns) { return ns / 1000.0; };
+    for (std::size_t o = 0; o < NUM_OPERACIONES_MEDIDAS; o++) {
+        const HistogramaLatencia& h = latencias[o];
+        if (h.cantidad() == 0) continue;
+        std::cout << std::left << std::setw(16) << nombreOperacion(static_cast<OperacionMedida>(o))
+                  << std::right << std::setw(10) << h.cantidad()
+                  << std::setw(11) << us(h.promedio()) << std::setw(10) << us(h.percentil(0.50))
+                  << std::setw(10) << us(h.percentil(0.90))
+                  << std::setw(10) << us(h.percentil(0.99)) << std::setw(11) << us(h.maximo())
+                  << "\n";
+    }
+
+    std::cout << "\nRechazos por motivo:\n";
+    bool alguno = false;
+    for (std::size_t o = 0; o < NUM_OPERACIONES_MEDIDAS; o++) {
+        for (std::size_t r = 1; r < NUM_CODIGOS_RESULTADO; r++) {
+            std::uint64_t n = resultados[o][r].load(std::memory_order_relaxed);
+            if (n == 0) continue;
+            std::cout << "  " << std::left << std::setw(16)
+                      << nombreOperacion(static_cast<OperacionMedida>(o)) << std::setw(22)
+                      << nombreResultado(static_cast<CodigoResultado>(r)) << std::right << n
+                      << "\n";
+            alguno = true;
+        }
+    }
+    if (!alguno) std::cout << "  (ninguno)\n";
+    std::cout << "*************************************************************\n";
+}
+
+std::string Metricas::aJson() const {
+    std::string json = "{\"momento\":" + std::to_string(momentoActual()) + ",\"operaciones\":{";
+    for (std::size_t o = 0; o < NUM_OPERACIONES_MEDIDAS; o++) {
+        const HistogramaLatencia& h = latencias[o];
+        if (o > 0) json += ',';
+        json += '"';
+        json += nombreOperacion(static_cast<OperacionMedida>(o));
+        json += "\":{\"cantidad\":" + std::to_string(h.cantidad()) +
+                ",\"promedioNs\":" + std::to_string(h.promedio()) +
+                ",\"p50Ns\":" + std::to_string(h.percentil(0.50)) +
+                ",\"p90Ns\":" + std::to_string(h.percentil(0.90)) +
+                ",\"p99Ns\":" + std::to_string(h.percentil(0.99)) +
+                ",\"maxNs\":" + std::to_string(h.maximo()) + ",\"resultados\":{";
+        bool primero = true;
+        for (std::size_t r = 0; r < NUM_CODIGOS_RESULTADO; r++) {
+            std::uint64_t n = resultados[o][r].load(std::memory_order_relaxed);
+            if (n == 0) continue;
+            json += primero ? "\"" : ",\"";
+            json += nombreResultado(static_cast<CodigoResultado>(r));
+            json += "\":" + std::to_string(n);
+            primero = false;
+        }
+        json += "}}";
+    }
+    json += "}}\n";
+    return json;
+}
+
+VolcadoMetricas::VolcadoMetricas(const Metricas& metricas, const std::string& archivo,
+                                 std::chrono::seconds intervalo)
+    : metricas(metricas), archivo(archivo), intervalo(intervalo), detener(false),
+      hilo(&VolcadoMetricas::ejecutar, this) {}
+
+VolcadoMetricas::~VolcadoMetricas() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        detener = true;
+    }
+    despertar.notify_one();
+    hilo.join();
+    volcar();
+}
+
+void VolcadoMetricas::volcar() const {
+    const std::string json = metricas.aJson();
+    if (!escribirArchivoAtomico(archivo, json.data(), json.size())) {
+        std::cerr << "ERROR: No se pudo escribir " << archivo << "\n";
+    }
+}
+
+void VolcadoMetricas::ejecutar() {
+    std::unique_lock<std::mutex> bloqueo(mutex);
+    while (!despertar.wait_for(bloqueo, intervalo, [this] { return detener; })) {
+        bloqueo.unlock();
+        volcar();
+        bloqueo.lock();
+    }
+}
+
+// =================================================================================
+// ARCHIVO: CargaTexto.cpp
+// =================================================================================
+
+namespace {
+
+// Por debajo de este tamanio un hilo extra cuesta mas de lo que ahorra
+constexpr std::size_t BYTES_MINIMOS_POR_TROZO = 1 << 20;
+
+// Recorre los campos de una linea separados por '|'
+class CamposLinea {
+private:
+    const char* actual;
+    const char* fin;
+    bool quedan;
+
+public:
+    CamposLinea(const char* inicio, const char* fin) : actual(inicio), fin(fin), quedan(true) {}
+
+    bool siguiente(std::string_view& campo) {
+        if (!quedan) return false;
+        const char* separador = static_cast<const char*>(std::memchr(actual, '|', fin - actual));
+        const char* finCampo = separador != nullptr ? separador : fin;
+        campo = std::string_view(actual, static_cast<std::size_t>(finCampo - actual));
+        if (separador != nullptr) {
+            actual = separador + 1;
+        } else {
+            quedan = false;
+        }
+        return true;
+    }
+
+    bool agotada() const { return !quedan; }
+};
+
+template <typename T>
+bool enteroCompleto(std::string_view campo, T& valor) {
+    const char* fin = campo.data() + campo.size();
+    auto r = std::from_chars(campo.data(), fin, valor);
+    return r.ec == std::errc() && r.ptr == fin && !campo.empty();
+}
+
+// Lanza funcion(trozo) para cada trozo: el primero en este hilo, el resto en paralelo
+template <typename Funcion>
+void paraCadaTrozo(std::vector<TrozoTexto>& trozos, Funcion funcion) {
+    std::vector<std::future<void>> hilos;
+    hilos.reserve(trozos.size());
+    for (std::size_t t = 1; t < trozos.size(); t++) {
+        hilos.push_back(std::async(std::launch::async, [&funcion, &trozos, t] {
+            funcion(trozos[t]);
+        }));
+    }
+    if (!trozos.empty()) funcion(trozos[0]);
+    for (auto& hilo : hilos) hilo.get();
+}
+
+// Inicio de la linea n (desde 0); nullptr si el archivo tiene menos lineas
+const char* inicioDeLinea(const std::vector<TrozoTexto>& trozos, std::size_t n) {
+    for (std::size_t t = trozos.size(); t-- > 0;) {
+        const TrozoTexto& trozo = trozos[t];
+        if (trozo.primeraLinea > n) continue;
+        const char* p = trozo.inicio;
+        for (std::size_t k = trozo.primeraLinea; k < n; k++) {
+            p = static_cast<const char*>(std::memchr(p, '\n', trozo.fin - p));
+            if (p == nullptr) return nullptr;
+            p++;
+        }
+        return p < trozo.fin ? p : nullptr;
+    }
+    return nullptr;
+}
+
+// Lee una linea de cabecera con un solo numero
+bool leerConteo(const std::vector<TrozoTexto>& trozos, std::size_t n, std::size_t& valor) {
+    const char* p = inicioDeLinea(trozos, n);
+    if (p == nullptr) return false;
+    const char* fin = trozos.back().fin;
+    const char* finLinea = static_cast<const char*>(std::memchr(p, '\n', fin - p));
+    if (finLinea == nullptr) finLinea = fin;
+    if (finLinea > p && finLinea[-1] == '\r') finLinea--;
+    return enteroCompleto(std::string_view(p, static_cast<std::size_t>(finLinea - p)), valor);
+}
+
+void analizarMiembro(TrozoTexto& trozo, std::size_t linea, const char* p, const char* fin) {
+    CamposLinea campos(p, fin);
+    std::string_view nombre, id, tipo, activo, dias, historial;
+    if (!campos.siguiente(nombre) || !campos.siguiente(id) || !campos.siguiente(tipo) ||
+        !campos.siguiente(activo) || !campos.siguiente(dias)) {
+        trozo.malformadas.push_back({linea, "miembro con campos faltantes; se ignora"});
+        return;
+    }
+    MiembroTexto m{};
+    m.nombre = nombre;
+    m.linea = linea;
+    if (!enteroCompleto(id, m.id)) {
+        trozo.malformadas.push_back({linea, "ID de miembro no numerico; se ignora"});
+        return;
+    }
+    if (!parsearTipoMembresia(tipo, m.tipo)) {
+        trozo.malformadas.push_back({linea, "membresia desconocida; se ignora el miembro"});
+        return;
+    }
+    if ((activo != "0" && activo != "1") || !enteroCompleto(dias, m.diasAsistencia)) {
+        trozo.malformadas.push_back({linea, "estado o asistencias invalidos; se ignora el miembro"});
+        return;
+    }
+    m.activo = activo == "1";
+
+    // Historial opcional (archivos anteriores no lo traen): primerMomento;delta;delta...
+    m.primerMomento = static_cast<std::uint32_t>(trozo.momentos.size());
+    if (campos.siguiente(historial)) {
+        const char* h = historial.data();
+        const char* finHistorial = h + historial.size();
+        std::int64_t momento = 0, valor = 0;
+        bool legible = campos.agotada();
+        while (legible && h < finHistorial) {
+            auto r = std::from_chars(h, finHistorial, valor);
+            if (r.ec != std::errc() || (r.ptr < finHistorial && *r.ptr != ';')) {
+                legible = false;
+                break;
+            }
+            momento += valor;
+            trozo.momentos.push_back(momento);
+            h = r.ptr < finHistorial ? r.ptr + 1 : finHistorial;
+        }
+        if (!legible) {
+            trozo.malformadas.push_back({linea, "historial ilegible; se conserva hasta el error"});
+        }
+    }
+    m.numMomentos = static_cast<std::uint32_t>(trozo.momentos.size() - m.primerMomento);
+    trozo.miembros.push_back(m);
+}
+
+void analizarClase(TrozoTexto& trozo, std::size_t linea, const char* p, const char* fin) {
+    CamposLinea campos(p, fin);
+    ClaseTexto c{};
+    std::string_view capacidad;
+    c.linea = linea;
+    if (!campos.siguiente(c.nombre) || !campos.siguiente(c.instructor) ||
+        !campos.siguiente(c.horario) || !campos.siguiente(c.codigo) ||
+        !campos.siguiente(capacidad) || !campos.agotada()) {
+        trozo.malformadas.push_back({linea, "clase con campos faltantes o de mas; se ignora"});
+        return;
+    }
+    if (!enteroCompleto(capacidad, c.capacidad)) {
+        trozo.malformadas.push_back({linea, "capacidad no numerica; se ignora la clase"});
+        return;
+    }
+    trozo.clases.push_back(c);
+}
+
+void analizarInscripcion(TrozoTexto& trozo, std::size_t linea, const char* p, const char* fin) {
+    if (p == fin) return;  // lineas vacias al final del archivo
+    const char* separador = static_cast<const char*>(std::memchr(p, '|', fin - p));
+    if (separador == nullptr) {
+        trozo.malformadas.push_back({linea, "inscripciones sin '|'; se ignora"});
+        return;
+    }
+    FilaInscripcionTexto fila{};
+    fila.codigo = std::string_view(p, static_cast<std::size_t>(separador - p));
+    fila.primerId = static_cast<std::uint32_t>(trozo.idsInscritos.size());
+    p = separador + 1;
+    while (p < fin) {
+        std::int32_t id = 0;
+        auto r = std::from_chars(p, fin, id);
+        if (r.ec != std::errc() || (r.ptr < fin && *r.ptr != ',')) {
+            trozo.malformadas.push_back({linea, "ID inscrito ilegible; se conserva hasta el error"});
+            break;
+        }
+        trozo.idsInscritos.push_back(id);
+        p = r.ptr < fin ? r.ptr + 1 : fin;
+    }
+    fila.numIds = static_cast<std::uint32_t>(trozo.idsInscritos.size() - fila.primerId);
+    trozo.inscripciones.push_back(fila);
+}
+
+}  // namespace
+
+bool analizarTextoGimnasio(const char* datos, std::size_t largo, TextoGimnasio& texto,
+                           std::size_t cantidadTrozos) {
+    // Trozos de igual tamanio, cada corte movido hasta despues del siguiente '\n'
+    std::size_t hilos = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t cantidad = cantidadTrozos > 0
+                               ? cantidadTrozos
+                               : std::max<std::size_t>(
+                                     1, std::min(hilos, largo / BYTES_MINIMOS_POR_TROZO));
+    const char* fin = datos + largo;
+    const char* inicio = datos;
+    texto.trozos.clear();
+    texto.trozos.reserve(cantidad);
+    for (std::size_t t = 1; t <= cantidad && inicio < fin; t++) {
+        const char* corte = t == cantidad ? fin : datos + largo / cantidad * t;
+        if (corte < inicio) corte = inicio;
+        const char* salto = static_cast<const char*>(std::memchr(corte, '\n', fin - corte));
+        corte = salto != nullptr ? salto + 1 : fin;
+        texto.trozos.emplace_back();
+        texto.trozos.back().inicio = inicio;
+        texto.trozos.back().fin = corte;
+        inicio = corte;
+    }
+
+    // Primera pasada: contar lineas por trozo para numerar cada linea del archivo
+    paraCadaTrozo(texto.trozos, [](TrozoTexto& trozo) {
+        trozo.saltos = static_cast<std::size_t>(std::count(trozo.inicio, trozo.fin, '\n'));
+    });
+    std::size_t lineas = 0;
+    for (TrozoTexto& trozo : texto.trozos) {
+        trozo.primeraLinea = lineas;
+        lineas += trozo.saltos;
+    }
+
+    // Cabeceras: miembros en la linea 0, clases tras los miembros, aristas al final
+    if (!leerConteo(texto.trozos, 0, texto.numMiembros)) return false;
+    const std::size_t lineaClases = texto.numMiembros + 1;
+    if (inicioDeLinea(texto.trozos, lineaClases) != nullptr &&
+        !leerConteo(texto.trozos, lineaClases, texto.numClases)) {
+        return false;
+    }
+    const std::size_t lineaAristas = lineaClases + texto.numClases + 1;
+    bool aristasIlegibles = inicioDeLinea(texto.trozos, lineaAristas) != nullptr &&
+                            !leerConteo(texto.trozos, lineaAristas, texto.numAristas);
+
+    // Segunda pasada: cada linea segun la seccion a la que pertenece
+    paraCadaTrozo(texto.trozos, [&](TrozoTexto& trozo) {
+        auto lineasEn = [&](std::size_t desde, std::size_t hasta) {
+            std::size_t a = std::max(desde, trozo.primeraLinea);
+            std::size_t b = std::min(hasta, trozo.primeraLinea + trozo.saltos + 1);
+            return b > a ? b - a : 0;
+        };
+        trozo.miembros.reserve(lineasEn(1, lineaClases));
+        trozo.clases.reserve(lineasEn(lineaClases + 1, lineaAristas));
+        trozo.inscripciones.reserve(lineasEn(lineaAristas + 1, lineas + 1));
+        std::size_t linea = trozo.primeraLinea;
+        const char* p = trozo.inicio;
+        while (p < trozo.fin) {
+            const char* finLinea = static_cast<const char*>(
+                std::memchr(p, '\n', trozo.fin - p));
+            if (finLinea == nullptr) finLinea = trozo.fin;
+            const char* finUtil = finLinea > p && finLinea[-1] == '\r' ? finLinea - 1 : finLinea;
+            if (linea >= 1 && linea < lineaClases) {
+                analizarMiembro(trozo, linea + 1, p, finUtil);
+            } else if (linea > lineaClases && linea < lineaAristas) {
+                analizarClase(trozo, linea + 1, p, finUtil);
+            } else if (linea > lineaAristas) {
+                analizarInscripcion(trozo, linea + 1, p, finUtil);
+            }
+            if (finLinea == trozo.fin) break;
+            p = finLinea + 1;
+            linea++;
+        }
+    });
+
+    if (aristasIlegibles) {
+        auto trozo = std::find_if(texto.trozos.rbegin(), texto.trozos.rend(),
+                                  [&](const TrozoTexto& t) { return t.primeraLinea <= lineaAristas; });
+        LineaMalformada aviso{lineaAristas + 1, "conteo de inscripciones no numerico"};
+        auto& lista = trozo->malformadas;
+        lista.insert(std::upper_bound(lista.begin(), lista.end(), aviso,
+                                      [](const LineaMalformada& a, const LineaMalformada& b) {
+                                          return a.linea < b.linea;
+                                      }),
+                     aviso);
+    }
+    if (inicioDeLinea(texto.trozos, lineaAristas - 1) == nullptr) {
+        std::cout << "ADVERTENCIA: El archivo termina antes de lo que indican sus cabeceras ("
+                  << texto.numMiembros << " miembros, " << texto.numClases << " clases).\n";
+    }
+    return true;
+}
+
+void TextoGimnasio::mostrarMalformadas() const {
+    std::size_t total = 0;
+    for (const TrozoTexto& trozo : trozos) {
+        for (const LineaMalformada& l : trozo.malformadas) {
+            if (++total <= MAX_LINEAS_REPORTADAS) {
+                std::cout << "ADVERTENCIA: Linea " << l.linea << ": " << l.motivo << ".\n";
+            }
+        }
+    }
+    if (total > MAX_LINEAS_REPORTADAS) {
+        std::cout << "ADVERTENCIA: " << total << " lineas con problemas en total (se muestran las "
+                  << MAX_LINEAS_REPORTADAS << " primeras).\n";
+    }
+}
+
+// =================================================================================
+// ARCHIVO: Importacion.cpp
+// =================================================================================
+
+const char* nombreMotivoRechazo(MotivoRechazo motivo) {
+    static const char* const NOMBRES[] = {
+        "FilaMalformada", "IdInvalido", "MembresiaInvalida", "IdRepetidoEnArchivo",
+        "IdYaRegistrado"
+    };
+    static_assert(sizeof(NOMBRES) / sizeof(NOMBRES[0]) == NUM_MOTIVOS_RECHAZO,
+                  "Cada MotivoRechazo necesita su nombre");
+    return NOMBRES[static_cast<std::size_t>(motivo)];
+}
+
+void ResultadoImportacion::mostrar() const {
+    std::cout << "\n========= IMPORTACION DE MIEMBROS =========\n";
+    if (!cabeceraValida) {
+        std::cout << "ERROR: La cabecera debe incluir las columnas id, nombre y membresia.\n"
+                  << "===========================================\n";
+        return;
+    }
+    std::cout << "Filas leidas: " << filas << "\n"
+              << "Importados: " << importados << "\n"
+              << "Rechazados: " << rechazos.size() << "\n";
+    for (std::size_t m = 0; m < NUM_MOTIVOS_RECHAZO; m++) {
+        if (porMotivo[m] > 0) {
+            std::cout << "  " << nombreMotivoRechazo(static_cast<MotivoRechazo>(m)) << ": "
+                      << porMotivo[m] << "\n";
+        }
+    }
+    if (!rechazos.empty()) {
+        std::cout << "Lineas rechazadas:";
+        for (std::size_t i = 0; i < rechazos.size() && i < MAX_RECHAZOS_MOSTRADOS; i++) {
+            std::cout << " " << rechazos[i].linea << " ("
+                      << nombreMotivoRechazo(rechazos[i].motivo) << ")";
+        }
+        if (rechazos.size() > MAX_RECHAZOS_MOSTRADOS) std::cout << " ...";
+        std::cout << "\n";
+    }
+    std::cout << "===========================================\n";
+}
+
+void LectorCsv::saltarLinea() {
+    const char* salto = static_cast<const char*>(std::memchr(actual, '\n', fin - actual));
+    if (salto == nullptr) {
+        actual = fin;
+    } else {
+        actual = salto + 1;
+        linea++;
+    }
+}
+
+bool LectorCsv::siguienteFila(std::vector<std::string>& campos, std::size_t& cantidad,
+                              std::uint32_t& lineaFila, bool& correcta) {
+    if (actual >= fin) return false;
+    lineaFila = linea;
+    cantidad = 0;
+    correcta = true;
+    while (true) {
+        if (cantidad == campos.size()) campos.emplace_back();
+        std::string& campo = campos[cantidad++];
+        campo.clear();
+        if (*actual == '"') {
+            actual++;
+            while (true) {
+                if (actual >= fin) {  // comilla sin cerrar hasta el final
+                    correcta = false;
+                    return true;
+                }
+                char c = *actual++;
+                if (c == '"') {
+                    if (actual < fin && *actual == '"') {
+                        campo += '"';
+                        actual++;
+                        continue;
+                    }
+                    break;
+                }
+                if (c == '\n') linea++;
+                campo += c;
+            }
+            if (actual < fin && *actual == '\r') actual++;
+        } else {
+            const char* inicio = actual;
+            while (actual < fin && *actual != ',' && *actual != '\n') actual++;
+            const char* finCampo = actual;
+            if (finCampo > inicio && finCampo[-1] == '\r') finCampo--;
+            campo.assign(inicio, finCampo);
+        }
+
+        if (actual >= fin) return true;
+        if (*actual == ',') {
+            actual++;
+            if (actual >= fin) {  // coma final: ultimo campo vacio
+                if (cantidad == campos.size()) campos.emplace_back();
+                campos[cantidad++].clear();
+                return true;
+            }
+            continue;
+        }
+        if (*actual == '\n') {
+            actual++;
+            linea++;
+            return true;
+        }
+        correcta = false;  // texto despues de la comilla de cierre
+        saltarLinea();
+        return true;
+    }
+}
+
+bool analizarCsvMiembros(const char* datos, std::size_t largo,
+                         std::vector<FilaImportacion>& filas, ResultadoImportacion& resultado) {
+    LectorCsv lector(datos, largo);
+    std::vector<std::string> campos;
+    std::size_t cantidad = 0;
+    std::uint32_t linea = 0;
+    bool correcta = true;
+
+    // Columnas por defecto (sin cabecera); -1 = ausente
+    int colId = 0, colNombre = 1, colMembresia = 2, colActivo = 3;
+    bool primera = true;
+    auto esEntero = [](const std::string& texto, int& valor) {
+        auto r = std::from_chars(texto.data(), texto.data() + texto.size(), valor);
+        return r.ec == std::errc() && r.ptr == texto.data() + texto.size() && !texto.empty();
+    };
+
+    // Estimacion de filas para reservar una sola vez
+    filas.reserve(static_cast<std::size_t>(std::count(datos, datos + largo, '\n')) + 1);
+    while (lector.siguienteFila(campos, cantidad, linea, correcta)) {
+        if (correcta && cantidad == 1 && campos[0].empty()) continue;  // linea vacia
+        int valor = 0;
+        if (primera) {
+            primera = false;
+            if (correcta && !esEntero(campos[0], valor)) {
+                colId = colNombre = colMembresia = colActivo = -1;
+                for (std::size_t c = 0; c < cantidad; c++) {
+                    const std::string& titulo = campos[c];
+                    int indice = static_cast<int>(c);
+                    if (titulo == "id") colId = indice;
+                    else if (titulo == "nombre") colNombre = indice;
+                    else if (titulo == "membresia") colMembresia = indice;
+                    else if (titulo == "activo") colActivo = indice;
+                }
+                if (colId < 0 || colNombre < 0 || colMembresia < 0) {
+                    resultado.cabeceraValida = false;
+                    return false;
+                }
+                continue;
+            }
+        }
+
+        resultado.filas++;
+        const int necesarias = std::max({colId, colNombre, colMembresia}) + 1;
+        if (!correcta || static_cast<int>(cantidad) < necesarias || campos[colNombre].empty()) {
+            resultado.rechazar(linea, MotivoRechazo::FilaMalformada);
+            continue;
+        }
+        FilaImportacion fila;
+        fila.linea = linea;
+        if (!esEntero(campos[colId], fila.id)) {
+            resultado.rechazar(linea, MotivoRechazo::IdInvalido);
+            continue;
+        }
+        if (!parsearTipoMembresia(campos[colMembresia], fila.tipo)) {
+            resultado.rechazar(linea, MotivoRechazo::MembresiaInvalida);
+            continue;
+        }
+        fila.activo = true;
+        if (colActivo >= 0 && colActivo < static_cast<int>(cantidad)) {
+            const std::string& activo = campos[colActivo];
+            if (activo == "0") {
+                fila.activo = false;
+            } else if (activo != "1" && !activo.empty()) {
+                resultado.rechazar(linea, MotivoRechazo::FilaMalformada);
+                continue;
+            }
+        }
+        fila.nombre = campos[colNombre];
+        filas.push_back(std::move(fila));
+    }
+    return true;
+}
+
+void descartarIdsRepetidos(std::vector<FilaImportacion>& filas, ResultadoImportacion& resultado) {
+    std::vector<std::uint32_t> orden(filas.size());
+    std::iota(orden.begin(), orden.end(), 0u);
+    // stable: dentro de un mismo ID queda primero la fila que aparece antes
+    std::stable_sort(orden.begin(), orden.end(), [&filas](std::uint32_t a, std::uint32_t b) {
+        return filas[a].id < filas[b].id;
+    });
+    std::vector<bool> repetida(filas.size(), false);
+    for (std::size_t i = 1; i < orden.size(); i++) {
+        if (filas[orden[i]].id == filas[orden[i - 1]].id) {
+            repetida[orden[i]] = true;
+            resultado.rechazar(filas[orden[i]].linea, MotivoRechazo::IdRepetidoEnArchivo);
+        }
+    }
+    std::size_t destino = 0;
+    for (std::size_t i = 0; i < filas.size(); i++) {
+        if (!repetida[i]) {
+            if (destino != i) filas[destino] = std::move(filas[i]);
+            destino++;
+        }
+    }
+    filas.resize(destino);
+}
+
+// =================================================================================
+// ARCHIVO: Gimnasio.cpp
+// =================================================================================
+
+Gimnasio::Gimnasio(const std::string& nombre)
+    : nombre(nombre), cuposOcupados(0), cuposTotales(0), secuenciaAplicada(0),
+      secuenciaSnapshot(0), generacion(0) {
+    std::cout << "\n********************************************\n"
+              << "*  Bienvenido a " << nombre << "  *\n"
+              << "********************************************\n" << std::endl;
+}
+
+const char* nombreResultado(CodigoResultado resultado) {
+    static const char* const NOMBRES[] = {
+        "Ok", "MiembroNoEncontrado", "ClaseNoEncontrada", "MembresiaInactiva", "ClaseLlena",
+        "YaInscrito", "NoInscrito", "LimiteClases", "IdDuplicado", "CodigoDuplicado",
+        "MembresiaInvalida", "EnListaEspera", "ConflictoHorario"
+    };
+    static_assert(sizeof(NOMBRES) / sizeof(NOMBRES[0]) == NUM_CODIGOS_RESULTADO,
+                  "Cada CodigoResultado necesita su nombre");
+    return NOMBRES[static_cast<std::size_t>(resultado)];
+}
+
+Miembro* Gimnasio::buscarMiembroPorId(int idMiembro) {
+    Handle h = miembros.buscar(idMiembro);
+    return h != HANDLE_INVALIDO ? &miembros.obtener(h) : nullptr;
+}
+
+ClaseGym* Gimnasio::buscarClasePorCodigo(const std::string& codigo) {
+    Handle h = clases.buscar(codigo);
+    return h != HANDLE_INVALIDO ? &clases.obtener(h) : nullptr;
+}
+
+// Se llama con los bloqueos de la operacion tomados, asi el orden del journal
+// coincide con el orden en que se aplicaron operaciones que compiten entre si
+void Gimnasio::anotar(TipoRegistro tipo, const EscritorRegistro& registro) {
+    std::lock_guard<std::mutex> bloqueo(mutexJournal);
+    if (journal) {
+        secuenciaAplicada = journal->agregar(tipo, registro.datos());
+    }
+}
+
+CodigoResultado Gimnasio::ejecutarRegistroMiembro(const std::string& nombre, int idMiembro,
+                                                  TipoMembresia tipoMembresia) {
+    MedicionOperacion medir(metricas, OperacionMedida::RegistroMiembro);
+    std::unique_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    Handle h = miembros.insertar(idMiembro, nombre, idMiembro, tipoMembresia);
+    if (h == HANDLE_INVALIDO) {
+        return medir(CodigoResultado::IdDuplicado);
+    }
+    columnas.agregar(miembros.obtener(h));
+    indiceNombres.agregar(nombre, h);
+    if (journal) {
+        EscritorRegistro reg;
+        reg.entero(idMiembro);
+        reg.texto(nombre);
+        reg.texto(politicaMembresia(tipoMembresia).nombre);
+        anotar(TipoRegistro::RegistrarMiembro, reg);
+    }
+    return medir(CodigoResultado::Ok);
+}
+
+ResultadoImportacion Gimnasio::importarMiembros(const char* datos, std::size_t largo) {
+    const auto inicio = std::chrono::steady_clock::now();
+    ResultadoImportacion resultado;
+    std::vector<FilaImportacion> filas;
+    if (!analizarCsvMiembros(datos, largo, filas, resultado)) return resultado;
+    descartarIdsRepetidos(filas, resultado);
+
+    // Un solo bloqueo exclusivo y una sola reserva para todo el archivo
+    std::unique_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    miembros.reserve(miembros.size() + filas.size());
+    columnas.reserve(columnas.size() + filas.size());
+    for (const FilaImportacion& fila : filas) {
+        Handle h = miembros.insertar(fila.id, fila.nombre, fila.id, fila.tipo);
+        if (h == HANDLE_INVALIDO) {
+            resultado.rechazar(fila.linea, MotivoRechazo::IdYaRegistrado);
+            continue;
+        }
+        Miembro& m = miembros.obtener(h);
+        m.setMembresiaActiva(fila.activo);
+        columnas.agregar(m);
+        indiceNombres.agregarSinOrdenar(fila.nombre, h);
+        resultado.importados++;
+        if (journal) {
+            EscritorRegistro reg;
+            reg.entero(fila.id);
+            reg.texto(fila.nombre);
+            reg.texto(politicaMembresia(fila.tipo).nombre);
+            anotar(TipoRegistro::RegistrarMiembro, reg);
+            if (!fila.activo) {
+                EscritorRegistro estado;
+                estado.entero(fila.id);
+                estado.entero(0);
+                anotar(TipoRegistro::CambioEstado, estado);
+            }
+        }
+    }
+    indiceNombres.ordenar();
+    bloqueo.unlock();
+
+    std::stable_sort(resultado.rechazos.begin(), resultado.rechazos.end(),
+                     [](const RechazoImportacion& a, const RechazoImportacion& b) {
+                         return a.linea < b.linea;
+                     });
+    auto motivo = [&](MotivoRechazo m) { return resultado.porMotivo[static_cast<std::size_t>(m)]; };
+    metricas.registrarLatencia(OperacionMedida::Importacion, static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - inicio).count()));
+    metricas.contarResultado(OperacionMedida::Importacion, CodigoResultado::Ok,
+                             resultado.importados);
+    metricas.contarResultado(OperacionMedida::Importacion, CodigoResultado::IdDuplicado,
+                             motivo(MotivoRechazo::IdRepetidoEnArchivo) +
+                                 motivo(MotivoRechazo::IdYaRegistrado));
+    metricas.contarResultado(OperacionMedida::Importacion, CodigoResultado::MembresiaInvalida,
+                             motivo(MotivoRechazo::MembresiaInvalida));
+    return resultado;
+}
+
+CodigoResultado Gimnasio::ejecutarCreacionClase(const std::string& nombre,
+                                                const std::string& instructor,
+                                                const std::string& horario,
+                                                const std::string& codigo, int capacidad) {
+    MedicionOperacion medir(metricas, OperacionMedida::CreacionClase);
+    std::unique_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    Handle h = clases.insertar(codigo, nombre, instructor, horario, codigo, capacidad);
+    if (h == HANDLE_INVALIDO) {
+        return medir(CodigoResultado::CodigoDuplicado);
+    }
+    cuposTotales += capacidad;
+    lineaTiempo.agregar(h, clases.obtener(h).getIntervalos());
+    indiceInstructores.agregar(instructor, h);
+    if (journal) {
+        EscritorRegistro reg;
+        reg.texto(nombre);
+        reg.texto(instructor);
+        reg.texto(horario);
+        reg.texto(codigo);
+        reg.entero(capacidad);
+        anotar(TipoRegistro::CrearClase, reg);
+    }
+    return medir(CodigoResultado::Ok);
+}
+
+CodigoResultado Gimnasio::ejecutarAsistencia(int idMiembro, std::int64_t momento) {
+    MedicionOperacion medir(metricas, OperacionMedida::Asistencia);
+    BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+    Handle h = miembros.buscar(idMiembro);
+    if (h == HANDLE_INVALIDO) return medir(CodigoResultado::MiembroNoEncontrado);
+    Miembro* miembro = &miembros.obtener(h);
+    if (!miembro->estaActivo()) return medir(CodigoResultado::MembresiaInactiva);
+
+    miembro->registrarAsistencia(momento);
+    columnas.actualizar(h, *miembro);
+    asistenciasPorDia.registrar(diaLocal(momento), 1);
+    asistenciasPorHora.registrar(momento, 1);
+    if (journal) {
+        EscritorRegistro reg;
+        reg.entero(idMiembro);
+        reg.entero64(momento);
+        anotar(TipoRegistro::Asistencia, reg);
+    }
+    return medir(CodigoResultado::Ok);
+}
+
+int Gimnasio::ejecutarAsistenciasLote(const int* ids, std::size_t cantidad,
+                                      CodigoResultado* resultados, std::int64_t momento) {
+    const auto inicio = std::chrono::steady_clock::now();
+    std::array<std::uint64_t, NUM_CODIGOS_RESULTADO> porResultado{};
+    // Se ordenan las posiciones por ID para resolver cada miembro una sola vez,
+    // aunque pase varias veces por el torniquete dentro del mismo lote
+    std::vector<std::uint32_t> orden(cantidad);
+    for (std::size_t i = 0; i < cantidad; i++) orden[i] = static_cast<std::uint32_t>(i);
+    std::sort(orden.begin(), orden.end(), [ids](std::uint32_t a, std::uint32_t b) {
+        return ids[a] < ids[b];
+    });
+
+    int registradas = 0;
+    std::shared_lock<std::shared_mutex> estructura(mutexEstructura);
+    std::size_t i = 0;
+    while (i < cantidad) {
+        int id = ids[orden[i]];
+        std::size_t fin = i;
+        while (fin < cantidad && ids[orden[fin]] == id) fin++;
+
+        std::lock_guard<std::mutex> shard(mutexShard(id));
+        Handle h = miembros.buscar(id);
+        Miembro* miembro = h != HANDLE_INVALIDO ? &miembros.obtener(h) : nullptr;
+        CodigoResultado resultado = CodigoResultado::Ok;
+        if (miembro == nullptr) resultado = CodigoResultado::MiembroNoEncontrado;
+        else if (!miembro->estaActivo()) resultado = CodigoResultado::MembresiaInactiva;
+
+        for (std::size_t k = i; k < fin; k++) resultados[orden[k]] = resultado;
+        porResultado[static_cast<std::size_t>(resultado)] += fin - i;
+        if (resultado == CodigoResultado::Ok) {
+            int repeticiones = static_cast<int>(fin - i);
+            miembro->sumarAsistencias(repeticiones, momento);
+            columnas.actualizar(h, *miembro);
+            registradas += repeticiones;
+            // El registro se anota con el shard aun tomado: un cambio de estado
+            // concurrente del mismo miembro no puede quedar antes en el journal.
+            if (journal) {
+                EscritorRegistro reg;
+                reg.entero(repeticiones);
+                for (int r = 0; r < repeticiones; r++) reg.entero(id);
+                reg.entero64(momento);
+                anotar(TipoRegistro::AsistenciaLote, reg);
+            }
+        }
+        i = fin;
+    }
+
+    if (registradas > 0) {
+        asistenciasPorDia.registrar(diaLocal(momento), registradas);
+        asistenciasPorHora.registrar(momento, static_cast<std::uint32_t>(registradas));
+    }
+
+    metricas.registrarLatencia(OperacionMedida::AsistenciaLote, static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - inicio).count()));
+    for (std::size_t r = 0; r < NUM_CODIGOS_RESULTADO; r++) {
+        if (porResultado[r] > 0) {
+            metricas.contarResultado(OperacionMedida::AsistenciaLote,
+                                     static_cast<CodigoResultado>(r), porResultado[r]);
+        }
+    }
+    return registradas;
+}
+
+CodigoResultado Gimnasio::ejecutarInscripcion(int idMiembro, const std::string& codigoClase) {
+    MedicionOperacion medir(metricas, OperacionMedida::Inscripcion);
+    IdClase idClase = HANDLE_INVALIDO;
+    CodigoResultado resultado = aplicarInscripcion(idMiembro, codigoClase, idClase);
+    if (resultado == CodigoResultado::EnListaEspera || resultado == CodigoResultado::ClaseLlena) {
+        // Puede haber quedado un cupo libre por una cancelacion concurrente
+        promoverListaEspera(idClase);
+    }
+    return medir(resultado);
+}
+
+CodigoResultado Gimnasio::aplicarInscripcion(int idMiembro, const std::string& codigoClase,
+                                             IdClase& idClase) {
+    BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+    Miembro* miembro = buscarMiembroPorId(idMiembro);
+    idClase = clases.buscar(codigoClase);
+
+    if (miembro == nullptr) return CodigoResultado::MiembroNoEncontrado;
+    if (idClase == HANDLE_INVALIDO) return CodigoResultado::ClaseNoEncontrada;
+    std::lock_guard<std::mutex> franja(mutexFranja(idClase));
+    ClaseGym* clase = &clases.obtener(idClase);
+    if (!miembro->estaActivo()) return CodigoResultado::MembresiaInactiva;
+    if (clase->estaMiembroInscrito(idMiembro)) return CodigoResultado::YaInscrito;
+    if (miembro->getCantidadClasesInscritas() >= miembro->getPolitica().limiteClases) {
+        return CodigoResultado::LimiteClases;
+    }
+    if (miembro->getAgenda().buscarConflicto(clase->getIntervalos()) != HANDLE_INVALIDO) {
+        return CodigoResultado::ConflictoHorario;
+    }
+
+    // Nadie se salta la lista: con gente esperando tambien se entra a la cola
+    ListaEspera& espera = clase->getListaEspera();
+    if (!clase->tieneCupo() || !espera.empty()) {
+        if (!espera.agregar(idMiembro, miembro->getPolitica().prioridad)) {
+            return CodigoResultado::ClaseLlena;  // ya estaba esperando: no gana lugar
+        }
+    } else {
+        clase->inscribirMiembro(idMiembro);
+        miembro->inscribirseAClase(idClase, clase->getIntervalos());
+        cuposOcupados++;
+    }
+    if (journal) {
+        EscritorRegistro reg;
+        reg.entero(idMiembro);
+        reg.texto(codigoClase);
+        anotar(TipoRegistro::Inscripcion, reg);
+    }
+    return espera.contiene(idMiembro) ? CodigoResultado::EnListaEspera : CodigoResultado::Ok;
+}
+
+CodigoResultado Gimnasio::ejecutarCancelacion(int idMiembro, const std::string& codigoClase) {
+    MedicionOperacion medir(metricas, OperacionMedida::Cancelacion);
+    IdClase idClase = HANDLE_INVALIDO;
+    CodigoResultado resultado = aplicarCancelacion(idMiembro, codigoClase, idClase);
+    if (resultado == CodigoResultado::Ok) promoverListaEspera(idClase);
+    return medir(resultado);
+}
+
+CodigoResultado Gimnasio::aplicarCancelacion(int idMiembro, const std::string& codigoClase,
+                                             IdClase& idClase) {
+    BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+    Miembro* miembro = buscarMiembroPorId(idMiembro);
+    idClase = clases.buscar(codigoClase);
+
+    if (miembro == nullptr) return CodigoResultado::MiembroNoEncontrado;
+    if (idClase == HANDLE_INVALIDO) return CodigoResultado::ClaseNoEncontrada;
+    std::lock_guard<std::mutex> franja(mutexFranja(idClase));
+    ClaseGym* clase = &clases.obtener(idClase);
+    if (clase->estaMiembroInscrito(idMiembro)) {
+        clase->cancelarInscripcion(idMiembro);
+        miembro->cancelarClase(idClase);
+        cuposOcupados--;
+    } else if (!clase->getListaEspera().retirar(idMiembro)) {
+        return CodigoResultado::NoInscrito;
+    }
+
+    if (journal) {
+        EscritorRegistro reg;
+        reg.entero(idMiembro);
+        reg.texto(codigoClase);
+        anotar(TipoRegistro::Cancelacion, reg);
+    }
+    return CodigoResultado::Ok;
+}
+
+void Gimnasio::aplicarPromocion(int idMiembro, IdClase idClase) {
+    Miembro* miembro = buscarMiembroPorId(idMiembro);
+    ClaseGym& clase = clases.obtener(idClase);
+    clase.getListaEspera().retirar(idMiembro);
+
+    // Al salir de la cola se vuelven a revisar estado, limite y horario: pudieron
+    // cambiar mientras esperaba. Si ya no califica, pierde el lugar.
+    if (miembro != nullptr && miembro->estaActivo() && clase.tieneCupo() &&
+        !clase.estaMiembroInscrito(idMiembro) &&
+        miembro->getCantidadClasesInscritas() < miembro->getPolitica().limiteClases &&
+        miembro->getAgenda().buscarConflicto(clase.getIntervalos()) == HANDLE_INVALIDO) {
+        clase.inscribirMiembro(idMiembro);
+        miembro->inscribirseAClase(idClase, clase.getIntervalos());
+        cuposOcupados++;
+    }
+    if (journal) {
+        EscritorRegistro reg;
+        reg.entero(idMiembro);
+        reg.texto(clase.getCodigo());
+        anotar(TipoRegistro::Promocion, reg);
+    }
+}
+
+int Gimnasio::promoverListaEspera(IdClase idClase) {
+    if (idClase == HANDLE_INVALIDO) return 0;
+    int promovidos = 0;
+    while (true) {
+        // Se mira la cima solo con la franja; para promover hace falta ademas el
+        // shard del candidato, que va antes que la franja en el orden de bloqueo.
+        int candidato;
+        {
+            std::shared_lock<std::shared_mutex> estructura(mutexEstructura);
+            std::lock_guard<std::mutex> franja(mutexFranja(idClase));
+            ClaseGym& clase = clases.obtener(idClase);
+            if (!clase.tieneCupo()) return promovidos;
+            candidato = clase.getListaEspera().primero();
+        }
+        if (candidato < 0) return promovidos;
+
+        BloqueoMiembro bloqueo = bloquearMiembro(candidato);
+        std::lock_guard<std::mutex> franja(mutexFranja(idClase));
+        ClaseGym& clase = clases.obtener(idClase);
+        if (!clase.tieneCupo() || clase.getListaEspera().primero() != candidato) {
+            continue;  // otro hilo se adelanto; se vuelve a mirar
+        }
+        int antes = clase.getInscritos();
+        aplicarPromocion(candidato, idClase);
+        promovidos += clase.getInscritos() - antes;
+    }
+}
+
+CodigoResultado Gimnasio::ejecutarCambioEstado(int idMiembro, bool activa) {
+    MedicionOperacion medir(metricas, OperacionMedida::CambioEstado);
+    BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+    Handle h = miembros.buscar(idMiembro);
+    if (h == HANDLE_INVALIDO) return medir(CodigoResultado::MiembroNoEncontrado);
+    Miembro* miembro = &miembros.obtener(h);
+
+    miembro->setMembresiaActiva(activa);
+    columnas.actualizar(h, *miembro);
+    if (journal) {
+        EscritorRegistro reg;
+        reg.entero(idMiembro);
+        reg.entero(activa ? 1 : 0);
+        anotar(TipoRegistro::CambioEstado, reg);
+    }
+    return medir(CodigoResultado::Ok);
+}
+
+void Gimnasio::registrarMiembro(const std::string& nombre, int idMiembro,
+                                const std::string& tipoMembresia) {
+    TipoMembresia tipo;
+    if (!parsearTipoMembresia(tipoMembresia, tipo)) {
+        std::cout << "ERROR: Tipo de membresia '" << tipoMembresia
+                  << "' invalido (Basica/Premium/VIP).\n";
+        return;
+    }
+    if (ejecutarRegistroMiembro(nombre, idMiembro, tipo) != CodigoResultado::Ok) {
+        std::cout << "ERROR: Ya existe un miembro con ID " << idMiembro << "\n";
+        return;
+    }
+
+    std::cout << "INFO: Miembro '" << nombre << "' registrado exitosamente (ID: "
+              << idMiembro << ")\n";
+}
+
+void Gimnasio::mostrarMiembros() const {
+    std::size_t total;
+    {
+        std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+        total = miembros.size();
+    }
+    SalidaBuffer salida;
+    salida << "\n====== MIEMBROS REGISTRADOS ======\n";
+    if (total == 0) {
+        salida << "No hay miembros registrados.\n";
+    } else {
+        salida << "Total de miembros: " << total << "\n\n";
+        exportarMiembros(salida, FiltroMiembros(), FormatoExportacion::Texto);
+    }
+    salida << "==================================\n";
+}
+
+void Gimnasio::crearClase(const std::string& nombre, const std::string& instructor,
+                         const std::string& horario, const std::string& codigo,
+                         int capacidad) {
+    if (ejecutarCreacionClase(nombre, instructor, horario, codigo, capacidad)
+            != CodigoResultado::Ok) {
+        std::cout << "ERROR: Ya existe una clase con codigo " << codigo << "\n";
+        return;
+    }
+
+    std::cout << "INFO: Clase '" << nombre << "' creada exitosamente (Codigo: "
+              << codigo << ")\n";
+    std::vector<IntervaloSemanal> intervalos;
+    if (!parsearHorario(horario, intervalos)) {
+        std::cout << "ADVERTENCIA: Horario no reconocido (ej: 'Lun,Mie 18:00-19:00'); "
+                  << "la clase no participa en la deteccion de choques.\n";
+    }
+}
+
+void Gimnasio::mostrarHorarioClases() const {
+    bool vacio;
+    {
+        std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+        vacio = clases.empty();
+    }
+    SalidaBuffer salida;
+    salida << "\n======= HORARIO DE CLASES =======\n";
+    if (vacio) {
+        salida << "No hay clases programadas.\n";
+    } else {
+        exportarClases(salida, FiltroClases(), FormatoExportacion::Texto);
+    }
+    salida << "=================================\n";
+}
+
+Handle Gimnasio::exportarMiembros(SalidaBuffer& salida, const FiltroMiembros& filtro,
+                                  FormatoExportacion formato, Handle cursor,
+                                  std::size_t limite) const {
+    MedicionOperacion medir(metricas, OperacionMedida::Listado);
+    const std::int64_t ahora = momentoActual();
+
+    if (formato == FormatoExportacion::Csv && cursor == 0) {
+        salida << "id,nombre,membresia,activo,asistencias,clases_inscritas\n";
+    } else if (formato == FormatoExportacion::Json) {
+        salida << "{\"desde\":" << static_cast<std::int64_t>(cursor) << ",\"miembros\":[";
+    }
+    // Por tandas: se copian las filas bajo el bloqueo compartido y el shard de
+    // cada miembro, y se formatean y escriben ya sin ningun bloqueo
+    std::vector<FilaMiembro> filas;
+    std::size_t h = cursor;
+    std::size_t total = 0;
+    std::size_t escritos = 0;
+    do {
+        filas.clear();
+        {
+            std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+            total = columnas.size();
+            // El filtro se evalua sobre las columnas; solo las coincidencias tocan Miembro
+            auto copiarSiPasa = [&](std::size_t i, bool copiar) {
+                const Miembro& m = miembros.obtener(static_cast<Handle>(i));
+                std::lock_guard<std::mutex> shard(mutexShard(m.getIdMiembro()));
+                bool pasa =
+                    (filtro.tipoMembresia < 0 || columnas.tipos[i] == filtro.tipoMembresia) &&
+                    (filtro.activo < 0 || columnas.activos[i] == filtro.activo) &&
+                    columnas.dias[i] >= filtro.minAsistencias;
+                if (pasa && copiar) filas.push_back(m.capturarFila(ahora));
+                return pasa;
+            };
+            for (; h < total && escritos + filas.size() < limite &&
+                   filas.size() < FILAS_POR_TANDA; h++) {
+                copiarSiPasa(h, true);
+            }
+            if (escritos + filas.size() >= limite) {
+                while (h < total && !copiarSiPasa(h, false)) h++;  // sin paginas finales vacias
+            }
+        }
+
+        for (const FilaMiembro& m : filas) {
+            switch (formato) {
+                case FormatoExportacion::Texto:
+                    m.escribirInformacion(salida);
+                    salida << '\n';
+                    break;
+                case FormatoExportacion::Csv:
+                    salida << m.idMiembro << ',';
+                    salida.campoCsv(m.nombre);
+                    salida << ',' << m.getNombreMembresia() << ',' << (m.activo ? 1 : 0)
+                           << ',' << m.diasAsistencia << ',' << m.clasesInscritas << '\n';
+                    break;
+                case FormatoExportacion::Json:
+                    salida << (escritos > 0 ? ",{" : "{") << "\"id\":" << m.idMiembro
+                           << ",\"nombre\":";
+                    salida.cadenaJson(m.nombre);
+                    salida << ",\"membresia\":\"" << m.getNombreMembresia() << "\",\"activo\":"
+                           << (m.activo ? "true" : "false")
+                           << ",\"asistencias\":" << m.diasAsistencia
+                           << ",\"clasesInscritas\":" << m.clasesInscritas << '}';
+                    break;
+            }
+            escritos++;
+        }
+    } while (h < total && escritos < limite);
+
+    Handle siguiente = h < total ? static_cast<Handle>(h) : HANDLE_INVALIDO;
+    if (formato == FormatoExportacion::Json) {
+        salida << "],\"siguiente\":";
+        if (siguiente == HANDLE_INVALIDO) salida << "null";
+        else salida << static_cast<std::int64_t>(siguiente);
+        salida << "}\n";
+    }
+    medir(CodigoResultado::Ok);
+    return siguiente;
+}
+
+Handle Gimnasio::exportarClases(SalidaBuffer& salida, const FiltroClases& filtro,
+                                FormatoExportacion formato, Handle cursor,
+                                std::size_t limite) const {
+    MedicionOperacion medir(metricas, OperacionMedida::Listado);
+
+    if (formato == FormatoExportacion::Csv && cursor == 0) {
+        salida << "codigo,nombre,instructor,horario,inscritos,capacidad,en_espera\n";
+    } else if (formato == FormatoExportacion::Json) {
+        salida << "{\"desde\":" << static_cast<std::int64_t>(cursor) << ",\"clases\":[";
+    }
+    // El instructor se compara normalizado, igual que en IndiceInstructores, asi
+    // la exportacion y la consulta por instructor del menu dan las mismas clases
+    std::string instructorBuscado, instructorClase;
+    normalizarTexto(filtro.instructor, instructorBuscado);
+    // Igual que con los miembros: copia por tandas bajo la franja de cada clase
+    std::vector<FilaClase> filas;
+    std::size_t h = cursor;
+    std::size_t total = 0;
+    std::size_t escritos = 0;
+    do {
+        filas.clear();
+        {
+            std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+            total = clases.size();
+            auto copiarSiPasa = [&](std::size_t i, bool copiar) {
+                const ClaseGym& c = clases.obtener(static_cast<Handle>(i));
+                if (!filtro.instructor.empty()) {
+                    normalizarTexto(c.getInstructor(), instructorClase);
+                    if (instructorClase != instructorBuscado) return false;
+                }
+                std::lock_guard<std::mutex> franja(mutexFranja(static_cast<IdClase>(i)));
+                bool pasa = !filtro.soloConCupo || c.tieneCupo();
+                if (pasa && copiar) filas.push_back(c.capturarFila());
+                return pasa;
+            };
+            for (; h < total && escritos + filas.size() < limite &&
+                   filas.size() < FILAS_POR_TANDA; h++) {
+                copiarSiPasa(h, true);
+            }
+            if (escritos + filas.size() >= limite) {
+                while (h < total && !copiarSiPasa(h, false)) h++;
+            }
+        }
+
+        for (const FilaClase& c : filas) {
+            switch (formato) {
+                case FormatoExportacion::Texto:
+                    c.escribirInformacion(salida);
+                    salida << '\n';
+                    break;
+                case FormatoExportacion::Csv:
+                    salida.campoCsv(c.codigo);
+                    salida << ',';
+                    salida.campoCsv(c.nombre);
+                    salida << ',';
+                    salida.campoCsv(c.instructor);
+                    salida << ',';
+                    salida.campoCsv(c.horario);
+                    salida << ',' << c.inscritos << ',' << c.capacidad << ',' << c.enEspera
+                           << '\n';
+                    break;
+                case FormatoExportacion::Json:
+                    salida << (escritos > 0 ? ",{" : "{") << "\"codigo\":";
+                    salida.cadenaJson(c.codigo);
+                    salida << ",\"nombre\":";
+                    salida.cadenaJson(c.nombre);
+                    salida << ",\"instructor\":";
+                    salida.cadenaJson(c.instructor);
+                    salida << ",\"horario\":";
+                    salida.cadenaJson(c.horario);
+                    salida << ",\"inscritos\":" << c.inscritos
+                           << ",\"capacidad\":" << c.capacidad
+                           << ",\"enEspera\":" << c.enEspera << '}';
+                    break;
+            }
+            escritos++;
+        }
+    } while (h < total && escritos < limite);
+
+    Handle siguiente = h < total ? static_cast<Handle>(h) : HANDLE_INVALIDO;
+    if (formato == FormatoExportacion::Json) {
+        salida << "],\"siguiente\":";
+        if (siguiente == HANDLE_INVALIDO) salida << "null";
+        else salida << static_cast<std::int64_t>(siguiente);
+        salida << "}\n";
+    }
+    medir(CodigoResultado::Ok);
+    return siguiente;
+}
+
+std::vector<FilaClase> Gimnasio::capturarClases(const std::vector<IdClase>& ids) const {
+    std::vector<FilaClase> filas;
+    filas.reserve(ids.size());
+    std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    for (IdClase id : ids) {
+        std::lock_guard<std::mutex> franja(mutexFranja(id));
+        filas.push_back(clases.obtener(id).capturarFila());
+    }
+    return filas;
+}
+
+std::vector<IdClase> Gimnasio::clasesEntre(const IntervaloSemanal& ventana) const {
+    MedicionOperacion medir(metricas, OperacionMedida::Consulta);
+    std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    std::vector<IdClase> resultado;
+    lineaTiempo.paraCadaEntre(ventana, [&](IdClase clase, const IntervaloSemanal&) {
+        resultado.push_back(clase);
+    });
+    std::sort(resultado.begin(), resultado.end());
+    resultado.erase(std::unique(resultado.begin(), resultado.end()), resultado.end());
+    medir(CodigoResultado::Ok);
+    return resultado;
+}
+
+std::vector<Handle> Gimnasio::buscarMiembrosPorPrefijo(const std::string& prefijo,
+                                                       std::size_t limite) const {
+    MedicionOperacion medir(metricas, OperacionMedida::Consulta);
+    std::string normalizado;
+    normalizarTexto(prefijo, normalizado);
+    std::vector<Handle> resultado;
+    if (normalizado.empty() || limite == 0) {
+        medir(CodigoResultado::Ok);
+        return resultado;
+    }
+    std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    indiceNombres.paraCadaConPrefijo(normalizado, [&](Handle h) {
+        // Un nombre puede coincidir por mas de una palabra; 'limite' es chico
+        if (std::find(resultado.begin(), resultado.end(), h) == resultado.end()) {
+            resultado.push_back(h);
+        }
+        return resultado.size() < limite;
+    });
+    medir(CodigoResultado::Ok);
+    return resultado;
+}
+
+std::vector<IdClase> Gimnasio::clasesDeInstructor(const std::string& instructor) const {
+    MedicionOperacion medir(metricas, OperacionMedida::Consulta);
+    std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    const std::vector<IdClase>* clasesInstructor = indiceInstructores.buscar(instructor);
+    std::vector<IdClase> resultado;
+    if (clasesInstructor != nullptr) resultado = *clasesInstructor;
+    medir(CodigoResultado::Ok);
+    return resultado;
+}
+
+void Gimnasio::mostrarBusquedaMiembros(const std::string& prefijo) const {
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<Handle> encontrados = buscarMiembrosPorPrefijo(prefijo);
+    double us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - inicio).count();
+
+    const std::int64_t ahora = momentoActual();
+    std::vector<FilaMiembro> filas;
+    filas.reserve(encontrados.size());
+    {
+        std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+        for (Handle h : encontrados) {
+            const Miembro& m = miembros.obtener(h);
+            std::lock_guard<std::mutex> shard(mutexShard(m.getIdMiembro()));
+            filas.push_back(m.capturarFila(ahora));
+        }
+    }
+
+    SalidaBuffer salida;
+    salida << "\n======= MIEMBROS QUE EMPIEZAN CON '" << prefijo << "' =======\n";
+    if (filas.empty()) {
+        salida << "No hay coincidencias.\n";
+    }
+    for (const FilaMiembro& m : filas) {
+        salida << "  ID " << m.idMiembro << " - " << m.nombre << " ("
+               << m.getNombreMembresia() << ", " << (m.activo ? "ACTIVA" : "INACTIVA")
+               << ")\n";
+    }
+    std::ostringstream tiempo;
+    tiempo << std::fixed << std::setprecision(1) << us;
+    salida << encontrados.size() << " resultado(s) en " << tiempo.str() << " us\n"
+           << "=================================\n";
+}
+
+void Gimnasio::mostrarClasesDeInstructor(const std::string& instructor) const {
+    std::vector<FilaClase> filas = capturarClases(clasesDeInstructor(instructor));
+
+    SalidaBuffer salida;
+    salida << "\n======= CLASES DE " << instructor << " =======\n";
+    if (filas.empty()) {
+        salida << "Ese instructor no dicta clases.\n";
+    }
+    for (const FilaClase& c : filas) {
+        c.escribirInformacion(salida);
+        salida << '\n';
+    }
+    salida << "=================================\n";
+}
+
+void Gimnasio::mostrarClasesEnHorario(const std::string& consulta) const {
+    std::vector<IntervaloSemanal> ventanas;
+    if (!parsearHorario(consulta, ventanas)) {
+        std::cout << "ERROR: Formato invalido. Ejemplo: Lun 18:00-19:00\n";
+        return;
+    }
+    std::vector<IdClase> encontradas;
+    for (const IntervaloSemanal& ventana : ventanas) {
+        std::vector<IdClase> parcial = clasesEntre(ventana);
+        encontradas.insert(encontradas.end(), parcial.begin(), parcial.end());
+    }
+    std::sort(encontradas.begin(), encontradas.end());
+    encontradas.erase(std::unique(encontradas.begin(), encontradas.end()), encontradas.end());
+    std::vector<FilaClase> filas = capturarClases(encontradas);
+
+    SalidaBuffer salida;
+    salida << "\n======= CLASES EN " << consulta << " =======\n";
+    if (filas.empty()) {
+        salida << "No hay clases en ese horario.\n";
+    }
+    for (const FilaClase& c : filas) {
+        c.escribirInformacion(salida);
+        salida << '\n';
+    }
+    salida << "=================================\n";
+}
+
+void Gimnasio::registrarAsistencia(int idMiembro) {
+    CodigoResultado resultado = ejecutarAsistencia(idMiembro);
+    BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+    switch (resultado) {
+        case CodigoResultado::MiembroNoEncontrado:
+            std::cout << "ERROR: Miembro con ID " << idMiembro << " no encontrado.\n";
+            return;
+        case CodigoResultado::MembresiaInactiva:
+            std::cout << "ERROR: La membresia de " << buscarMiembroPorId(idMiembro)->getNombre()
+                      << " esta INACTIVA.\n";
+            return;
+        default:
+            break;
+    }
+
+    Miembro* miembro = buscarMiembroPorId(idMiembro);
+    std::cout << "EXITO: Asistencia registrada para " << miembro->getNombre()
+              << " (Total: " << miembro->getDiasAsistencia() << " dias)\n";
+}
+
+int Gimnasio::registrarAsistenciasLote(const int* ids, std::size_t cantidad,
+                                       CodigoResultado* resultados) {
+    return ejecutarAsistenciasLote(ids, cantidad, resultados);
+}
+
+void Gimnasio::inscribirMiembroAClase(int idMiembro, const std::string& codigoClase) {
+    CodigoResultado resultado = ejecutarInscripcion(idMiembro, codigoClase);
+    BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+    Miembro* miembro = buscarMiembroPorId(idMiembro);
+    ClaseGym* clase = buscarClasePorCodigo(codigoClase);
+
+    switch (resultado) {
+        case CodigoResultado::MiembroNoEncontrado:
+            std::cout << "ERROR: Miembro con ID " << idMiembro << " no encontrado.\n";
+            break;
+        case CodigoResultado::ClaseNoEncontrada:
+            std::cout << "ERROR: Clase con codigo " << codigoClase << " no encontrada.\n";
+            break;
+        case CodigoResultado::MembresiaInactiva:
+            std::cout << "ERROR: Membresia inactiva.\n";
+            break;
+        case CodigoResultado::ClaseLlena:
+            std::cout << "ERROR: La clase '" << clase->getNombre() << "' esta LLENA y "
+                      << miembro->getNombre() << " ya esta en su lista de espera.\n";
+            break;
+        case CodigoResultado::ConflictoHorario: {
+            IdClase otra = miembro->getAgenda().buscarConflicto(clase->getIntervalos());
+            std::cout << "ERROR: Choque de horario con la clase '"
+                      << (otra != HANDLE_INVALIDO ? clases.obtener(otra).getNombre() : "?")
+                      << "' en la que ya esta inscrito.\n";
+            break;
+        }
+        case CodigoResultado::EnListaEspera: {
+            std::lock_guard<std::mutex> franja(mutexFranja(buscarHandleClase(codigoClase)));
+            std::cout << "INFO: La clase '" << clase->getNombre() << "' esta LLENA. "
+                      << miembro->getNombre() << " quedo en lista de espera ("
+                      << clase->getListaEspera().size() << " esperando).\n";
+            break;
+        }
+        case CodigoResultado::YaInscrito:
+            std::cout << "ERROR: El miembro ya esta inscrito en esta clase.\n";
+            break;
+        case CodigoResultado::LimiteClases:
+            std::cout << "ERROR: Limite de clases alcanzado para membresia "
+                      << miembro->getNombreMembresia() << " ("
+                      << miembro->getPolitica().limiteClases << " clases).\n";
+            break;
+        default:
+            std::cout << "EXITO: " << miembro->getNombre() << " inscrito en '"
+                      << clase->getNombre() << "'\n";
+    }
+}
+
+void Gimnasio::cancelarInscripcionClase(int idMiembro, const std::string& codigoClase) {
+    switch (ejecutarCancelacion(idMiembro, codigoClase)) {
+        case CodigoResultado::MiembroNoEncontrado:
+        case CodigoResultado::ClaseNoEncontrada:
+            std::cout << "ERROR: Miembro o clase no encontrado.\n";
+            break;
+        case CodigoResultado::NoInscrito:
+            std::cout << "ERROR: El miembro no esta inscrito ni en espera en esta clase.\n";
+            break;
+        default:
+            std::cout << "EXITO: Inscripcion cancelada exitosamente.\n";
+    }
+}
+
+void Gimnasio::suspenderMembresia(int idMiembro) {
+    if (ejecutarCambioEstado(idMiembro, false) == CodigoResultado::Ok) {
+        BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+        std::cout << "INFO: Membresia de " << buscarMiembroPorId(idMiembro)->getNombre()
+                  << " suspendida.\n";
+    } else {
+        std::cout << "ERROR: Miembro no encontrado.\n";
+    }
+}
+
+void Gimnasio::reactivarMembresia(int idMiembro) {
+    if (ejecutarCambioEstado(idMiembro, true) == CodigoResultado::Ok) {
+        BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+        std::cout << "INFO: Membresia de " << buscarMiembroPorId(idMiembro)->getNombre()
+                  << " reactivada.\n";
+    } else {
+        std::cout << "ERROR: Miembro no encontrado.\n";
+    }
+}
+
+ResumenDiario Gimnasio::obtenerResumenDiario() const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    std::int64_t hoy = diaLocal(momentoActual());
+    return {miembros.size(), clases.size(), asistenciasPorDia.consultar(hoy),
+            asistenciasPorDia.consultar(hoy - 1), cuposOcupados.load(), cuposTotales.load()};
+}
+
+ResumenPorMembresia Gimnasio::obtenerResumenPorMembresia() const {
+    // Exclusivo: las columnas se actualizan bajo los shards, no bajo la estructura
+    std::unique_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    ResumenPorMembresia porTipo;
+    for (std::size_t t = 0; t < porTipo.size(); t++) {
+        porTipo[t] = resumirPorTipo(columnas, static_cast<std::uint8_t>(t));
+    }
+    return porTipo;
+}
+
+std::vector<int> Gimnasio::idsMiembros() const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    return std::vector<int>(columnas.ids.begin(), columnas.ids.end());
+}
+
+void Gimnasio::mostrarResumenDiario() const {
+    ResumenDiario resumen = obtenerResumenDiario();
+    std::cout << "\n********** RESUMEN DEL DIA **********\n"
+              << "Gimnasio: " << nombre << "\n"
+              << "Total de miembros: " << resumen.miembros << "\n"
+              << "Asistencias registradas hoy: " << resumen.asistenciasHoy
+              << " (ayer: " << resumen.asistenciasAyer << ")\n"
+              << "Clases programadas: " << resumen.clases << "\n"
+              << "Cupos ocupados: " << resumen.cuposOcupados << "/" << resumen.cuposTotales << "\n"
+              << "************************************\n";
+}
+
+CodigoResultado Gimnasio::contarAsistenciasMiembro(int idMiembro, std::int64_t desde,
+                                                   std::int64_t hasta,
+                                                   std::size_t& total) const {
+    MedicionOperacion medir(metricas, OperacionMedida::Consulta);
+    BloqueoMiembro bloqueo = bloquearMiembro(idMiembro);
+    Handle h = miembros.buscar(idMiembro);
+    if (h == HANDLE_INVALIDO) return medir(CodigoResultado::MiembroNoEncontrado);
+    total = miembros.obtener(h).getHistorial().contarEntre(desde, hasta);
+    return medir(CodigoResultado::Ok);
+}
+
+std::vector<std::uint32_t> Gimnasio::asistenciasPorHoraEntre(std::int64_t desde,
+                                                             std::int64_t hasta) const {
+    return asistenciasPorHora.consultar(desde, hasta);
+}
+
+void Gimnasio::mostrarHistorialAsistencias(int idMiembro) const {
+    const std::int64_t ahora = momentoActual();
+    const std::int64_t DIA = 86400;
+    std::size_t semana = 0, mes = 0;
+    if (contarAsistenciasMiembro(idMiembro, ahora - 7 * DIA, ahora + 1, semana) !=
+        CodigoResultado::Ok) {
+        std::cout << "ERROR: Miembro no encontrado.\n";
+        return;
+    }
+    contarAsistenciasMiembro(idMiembro, ahora - 30 * DIA, ahora + 1, mes);
+
+    // Hora del dia (local) con mas asistencias en todo el gimnasio, ultimos 30 dias
+    const std::int64_t desde = ahora - 30 * DIA;
+    std::vector<std::uint32_t> horas = asistenciasPorHoraEntre(desde, ahora + 1);
+    std::uint64_t porHoraDelDia[24] = {};
+    std::int64_t primeraHora = (desde >= 0 ? desde / 3600 : (desde - 3599) / 3600) * 3600;
+    for (std::size_t k = 0; k < horas.size(); k++) {
+        if (horas[k] == 0) continue;
+        std::time_t t = static_cast<std::time_t>(primeraHora + static_cast<std::int64_t>(k) * 3600);
+        std::tm local;
+        localtime_r(&t, &local);
+        porHoraDelDia[local.tm_hour] += horas[k];
+    }
+    int horaPico = static_cast<int>(std::max_element(porHoraDelDia, porHoraDelDia + 24) -
+                                    porHoraDelDia);
+
+    std::cout << "\n********** HISTORIAL DE ASISTENCIAS **********\n"
+              << "Miembro ID: " << idMiembro << "\n"
+              << "Visitas ultimos 7 dias: " << semana << "\n"
+              << "Visitas ultimos 30 dias: " << mes << "\n";
+    if (porHoraDelDia[horaPico] > 0) {
+        std::cout << "Hora pico del gimnasio (30 dias): " << std::setfill('0') << std::setw(2)
+                  << horaPico << ":00-" << std::setw(2) << (horaPico + 1) % 24 << ":00"
+                  << std::setfill(' ') << " (" << porHoraDelDia[horaPico] << " asistencias)\n";
+    }
+    std::cout << "**********************************************\n";
+}
+
+// Recalcula desde cero lo que se mantiene incrementalmente (tras una carga)
+void Gimnasio::reconstruirAgregados() {
+    columnas.clear();
+    columnas.reserve(miembros.size());
+    indiceNombres.clear();
+    for (Handle h = 0; h < miembros.size(); h++) {
+        const Miembro& m = miembros.obtener(h);
+        columnas.agregar(m);
+        indiceNombres.agregarSinOrdenar(m.getNombre(), h);
+    }
+    indiceNombres.ordenar();
+
+    std::int64_t ocupados = 0, totales = 0;
+    for (const auto& clase : clases) {
+        ocupados += clase.getInscritos();
+        totales += clase.getCapacidadMaxima();
+    }
+    cuposOcupados = ocupados;
+    cuposTotales = totales;
+
+    lineaTiempo.clear();
+    indiceInstructores.clear();
+    for (Handle h = 0; h < clases.size(); h++) {
+        lineaTiempo.agregar(h, clases.obtener(h).getIntervalos());
+        indiceInstructores.agregar(clases.obtener(h).getInstructor(), h);
+    }
+
+    // Los conteos diarios recientes salen del historial por hora
+    asistenciasPorDia.reiniciar();
+    const std::int64_t desde =
+        (diaLocal(momentoActual()) - static_cast<std::int64_t>(ContadorDiario::DIAS)) * 86400;
+    asistenciasPorHora.paraCada([&](std::int64_t hora, std::uint32_t conteo) {
+        if (hora >= desde) asistenciasPorDia.registrar(diaLocal(hora), conteo);
+    });
+}
+
+ColumnasMiembros Gimnasio::copiarColumnas() const {
+    // ids y tipos no cambian despues del alta; estado y asistencias se leen
+    // bajo el shard de cada miembro
+    ColumnasMiembros copia;
+    copia.ids = columnas.ids;
+    copia.tipos = columnas.tipos;
+    copia.activos.resize(columnas.size());
+    copia.dias.resize(columnas.size());
+    for (std::size_t h = 0; h < columnas.size(); h++) {
+        std::lock_guard<std::mutex> shard(mutexShard(columnas.ids[h]));
+        copia.activos[h] = columnas.activos[h];
+        copia.dias[h] = columnas.dias[h];
+    }
+    return copia;
+}
+
+void Gimnasio::mostrarReporteAnalitico() const {
+    // Los agregados se calculan sobre una copia de las columnas y la salida se
+    // arma sin bloqueos; solo los nombres del top vuelven a leerse de la estructura
+    auto inicio = std::chrono::steady_clock::now();
+    ColumnasMiembros copia;
+    {
+        std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+        copia = copiarColumnas();
+    }
+
+    ResumenColumnas porTipo[static_cast<std::size_t>(TipoMembresia::Cantidad)];
+    for (std::size_t t = 0; t < static_cast<std::size_t>(TipoMembresia::Cantidad); t++) {
+        porTipo[t] = resumirPorTipo(copia, static_cast<std::uint8_t>(t));
+    }
+    const std::int32_t limites[] = {0, 1, 5, 10, 20, std::numeric_limits<std::int32_t>::max()};
+    std::int64_t distribucion[5];
+    for (int b = 0; b < 5; b++) {
+        distribucion[b] = contarEnRango(copia, limites[b], limites[b + 1]);
+    }
+    std::vector<Handle> top = mayoresAsistentes(copia, 10);
+    std::vector<std::string> nombresTop;
+    {
+        std::shared_lock<std::shared_mutex> bloqueo(mutexEstructura);
+        for (Handle h : top) nombresTop.push_back(miembros.obtener(h).getNombre());
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - inicio).count();
+
+    std::cout << "\n********** REPORTE ANALITICO **********\n"
+              << "Miembros analizados: " << copia.size() << "\n\n"
+              << "Por membresia (miembros / activos / asistencias / promedio):\n";
+    std::int64_t activosTotales = 0;
+    for (std::size_t t = 0; t < static_cast<std::size_t>(TipoMembresia::Cantidad); t++) {
+        const ResumenColumnas& r = porTipo[t];
+        activosTotales += r.activos;
+        std::cout << "  " << std::left << std::setw(8) << POLITICAS_MEMBRESIA[t].nombre
+                  << std::right << std::setw(10) << r.miembros << std::setw(10) << r.activos
+                  << std::setw(12) << r.asistencias << std::setw(10) << std::fixed
+                  << std::setprecision(1)
+                  << (r.miembros > 0 ? double(r.asistencias) / r.miembros : 0.0) << "\n";
+    }
+    std::int64_t inactivos = static_cast<std::int64_t>(copia.size()) - activosTotales;
+    std::cout << "\nActivos/Inactivos: " << activosTotales << "/" << inactivos << "\n"
+              << "\nDistribucion de asistencias:\n";
+    const char* etiquetas[] = {"0", "1-4", "5-9", "10-19", "20+"};
+    for (int b = 0; b < 5; b++) {
+        std::cout << "  " << std::left << std::setw(6) << etiquetas[b] << std::right
+                  << std::setw(10) << distribucion[b] << "\n";
+    }
+    std::cout << "\nTop asistentes:\n";
+    for (std::size_t i = 0; i < top.size(); i++) {
+        std::cout << "  ID " << copia.ids[top[i]] << " - " << nombresTop[i]
+                  << ": " << copia.dias[top[i]] << " dias\n";
+    }
+    std::cout << "\nCalculado en " << std::setprecision(3) << ms << " ms\n"
+              << "***************************************\n";
+}
+
+// =================================================================================
+// PERSISTENCIA DE DATOS
+// =================================================================================
+
+void Gimnasio::cargarInscripciones(const GrafoCSR& porClase, const GrafoCSR& porMiembro,
+                                   const std::vector<Handle>& handleMiembro,
+                                   const std::vector<Handle>& handleClase) {
+    auto traducir = [](const std::vector<Handle>& mapa, std::uint32_t nodo) {
+        return nodo < mapa.size() ? mapa[nodo] : HANDLE_INVALIDO;
+    };
+    for (std::size_t c = 0; c < porClase.nodos(); c++) {
+        Handle hc = traducir(handleClase, static_cast<std::uint32_t>(c));
+        if (hc == HANDLE_INVALIDO) continue;
+        ClaseGym& clase = clases.obtener(hc);
+        clase.reservarInscritos(porClase.grado(c));
+        for (const std::uint32_t* v = porClase.inicio(c); v != porClase.fin(c); ++v) {
+            Handle hm = traducir(handleMiembro, *v);
+            if (hm != HANDLE_INVALIDO) clase.inscribirMiembro(miembros.obtener(hm).getIdMiembro());
+        }
+    }
+    for (std::size_t m = 0; m < porMiembro.nodos(); m++) {
+        Handle hm = traducir(handleMiembro, static_cast<std::uint32_t>(m));
+        if (hm == HANDLE_INVALIDO) continue;
+        Miembro& miembro = miembros.obtener(hm);
+        miembro.reservarClases(porMiembro.grado(m));
+        for (const std::uint32_t* v = porMiembro.inicio(m); v != porMiembro.fin(m); ++v) {
+            Handle hc = traducir(handleClase, *v);
+            if (hc != HANDLE_INVALIDO &&
+                clases.obtener(hc).estaMiembroInscrito(miembro.getIdMiembro())) {
+                miembro.inscribirseAClase(hc, clases.obtener(hc).getIntervalos());
+            }
+        }
+    }
+}
+
+void Gimnasio::guardarDatos(const std::string& archivo) {
+    MedicionOperacion medir(metricas, OperacionMedida::Guardado);
+    const std::string texto = imagenDatos();
+    if (!escribirArchivoAtomico(archivo, texto.data(), texto.size())) {
+        std::cout << "ERROR: No se pudo crear el archivo " << archivo << "\n";
+        return;
+    }
+    medir(CodigoResultado::Ok);
+    std::cout << "\n✅ Datos guardados exitosamente en '" << archivo << "'\n";
+}
+
+std::string Gimnasio::imagenDatos() const {
+    // Bajo el bloqueo solo se copia el estado crudo; el texto se arma sin el
+    const CapturaSnapshot captura = capturarSnapshot();
+    std::ostringstream file;
+
+    // Guardar miembros
+    file << captura.miembros.size() << "\n";
+    for (const auto& m : captura.miembros) {
+        file << captura.texto(m.nombre) << "|"
+             << m.idMiembro << "|"
+             << politicaMembresia(static_cast<TipoMembresia>(m.tipoMembresia)).nombre << "|"
+             << int(m.activo) << "|"
+             << m.diasAsistencia;
+        // Historial opcional: |primerMomento;delta;delta...
+        bool primero = true;
+        std::int64_t anterior = 0;
+        captura.historial(m).paraCadaEntre(
+            std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(),
+            [&](std::int64_t momento) {
+                file << (primero ? "|" : ";") << (primero ? momento : momento - anterior);
+                primero = false;
+                anterior = momento;
+            });
+        file << "\n";
+    }
+
+    // Guardar clases
+    file << captura.clases.size() << "\n";
+    for (const auto& c : captura.clases) {
+        file << captura.texto(c.nombre) << "|"
+             << captura.texto(c.instructor) << "|"
+             << captura.texto(c.horario) << "|"
+             << captura.texto(c.codigo) << "|"
+             << c.capacidadMaxima << "\n";
+    }
+
+    // Guardar inscripciones (una fila CSR por clase): codigo|id,id,...
+    GrafoCSR inscripciones = captura.porMiembro.transpuesto(captura.clases.size());
+    file << inscripciones.aristas() << "\n";
+    for (std::size_t c = 0; c < inscripciones.nodos(); c++) {
+        if (inscripciones.grado(c) == 0) continue;
+        file << captura.texto(captura.clases[c].codigo) << "|";
+        for (const std::uint32_t* v = inscripciones.inicio(c); v != inscripciones.fin(c); ++v) {
+            file << (v == inscripciones.inicio(c) ? "" : ",") << captura.miembros[*v].idMiembro;
+        }
+        file << "\n";
+    }
+    return file.str();
+}
+
+void Gimnasio::cargarDatos(const std::string& archivo, bool informar) {
+    ArchivoMapeado mapa(archivo);
+    
+    if (!mapa.valido()) {
+        std::cout << "⚠️  No se encontro archivo de datos previos. Iniciando desde cero.\n";
+        return;
+    }
+
+    MedicionOperacion medir(metricas, OperacionMedida::Carga);
+    const EstadisticasMemoria memoriaInicial = estadisticasMemoria();
+
+    // El analisis corre en paralelo y sin bloqueo; solo la fusion toca el gimnasio
+    TextoGimnasio texto;
+    if (!analizarTextoGimnasio(mapa.data(), mapa.size(), texto)) {
+        std::cout << "ERROR: '" << archivo << "' no tiene el formato de datos del gimnasio.\n";
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    miembros.clear();
+    clases.clear();
+    generacion++;
+    asistenciasPorHora.clear();
+
+    // Fusionar miembros, trozo por trozo en el orden del archivo
+    miembros.reserve(texto.numMiembros);
+    for (const TrozoTexto& trozo : texto.trozos) {
+        for (const MiembroTexto& leido : trozo.miembros) {
+            Handle h = miembros.insertar(leido.id, std::string(leido.nombre), leido.id, leido.tipo);
+            if (h == HANDLE_INVALIDO) {
+                std::cout << "ADVERTENCIA: ID duplicado " << leido.id << " (linea "
+                          << leido.linea << ") ignorado al cargar.\n";
+                continue;
+            }
+            Miembro& m = miembros.obtener(h);
+            m.setMembresiaActiva(leido.activo);
+            m.setDiasAsistencia(leido.diasAsistencia);
+            for (std::uint32_t k = 0; k < leido.numMomentos; k++) {
+                std::int64_t momento = trozo.momentos[leido.primerMomento + k];
+                m.getHistorial().agregar(momento);
+                asistenciasPorHora.registrar(momento, 1);
+            }
+        }
+    }
+
+    // Fusionar clases
+    clases.reserve(texto.numClases);
+    std::string codigo;
+    for (const TrozoTexto& trozo : texto.trozos) {
+        for (const ClaseTexto& leida : trozo.clases) {
+            codigo.assign(leida.codigo.data(), leida.codigo.size());
+            if (clases.insertar(codigo, std::string(leida.nombre), std::string(leida.instructor),
+                                std::string(leida.horario), codigo, leida.capacidad)
+                    == HANDLE_INVALIDO) {
+                std::cout << "ADVERTENCIA: Codigo duplicado " << codigo << " (linea "
+                          << leida.linea << ") ignorado al cargar.\n";
+            }
+        }
+    }
+
+    // Inscripciones (archivos anteriores no traen esta seccion). Cada fila pasa
+    // directo al CSR por clase; el sentido por miembro sale de transponerlo.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> aristas;  // (clase, miembro)
+    aristas.reserve(texto.numAristas);
+    for (const TrozoTexto& trozo : texto.trozos) {
+        for (const FilaInscripcionTexto& fila : trozo.inscripciones) {
+            codigo.assign(fila.codigo.data(), fila.codigo.size());
+            Handle hc = clases.buscar(codigo);
+            if (hc == HANDLE_INVALIDO) continue;
+            for (std::uint32_t k = 0; k < fila.numIds; k++) {
+                Handle hm = miembros.buscar(trozo.idsInscritos[fila.primerId + k]);
+                if (hm != HANDLE_INVALIDO) aristas.emplace_back(hc, hm);
+            }
+        }
+    }
+    if (!aristas.empty()) {
+        GrafoCSR porClase = GrafoCSR::desdeAristas(clases.size(), aristas);
+        std::vector<Handle> identidadMiembros(miembros.size());
+        std::vector<Handle> identidadClases(clases.size());
+        std::iota(identidadMiembros.begin(), identidadMiembros.end(), Handle(0));
+        std::iota(identidadClases.begin(), identidadClases.end(), Handle(0));
+        cargarInscripciones(porClase, porClase.transpuesto(miembros.size()),
+                            identidadMiembros, identidadClases);
+    }
+
+    reconstruirAgregados();
+    medir(CodigoResultado::Ok);
+    texto.mostrarMalformadas();
+    if (informar) {
+        std::cout << "✅ Datos cargados: " << miembros.size() << " miembros, "
+                  << clases.size() << " clases (" << estadisticasMemoria() - memoriaInicial
+                  << ")\n";
+    }
+}
+
+// Agrega un texto a la tabla de cadenas y devuelve su referencia
+static RefCadena agregarCadena(std::string& tabla, const std::string& texto) {
+    RefCadena ref{static_cast<std::uint32_t>(tabla.size()),
+                  static_cast<std::uint32_t>(texto.size())};
+    tabla += texto;
+    return ref;
+}
+
+bool Gimnasio::guardarSnapshot(const std::string& archivo) const {
+    MedicionOperacion medir(metricas, OperacionMedida::Guardado);
+    std::lock_guard<std::mutex> serie(mutexSnapshot);
+    const std::string imagen = imagenSnapshot();
+    if (!escribirArchivoAtomico(archivo, imagen.data(), imagen.size())) {
+        std::cout << "ERROR: No se pudo escribir el snapshot " << archivo << "\n";
+        return false;
+    }
+    std::cout << "\n✅ Snapshot guardado en '" << archivo << "' ("
+              << imagen.size() << " bytes)\n";
+    medir(CodigoResultado::Ok);
+    return true;
+}
+
+std::string Gimnasio::imagenSnapshot() const {
+    return capturarSnapshot().armarImagen();
+}
+
+CapturaSnapshot::MiembroCrudo CapturaSnapshot::copiarMiembro(const Miembro& m,
+                                                            RefCadena nombre) {
+    MiembroCrudo r{};
+    r.idMiembro = m.getIdMiembro();
+    r.tipoMembresia = static_cast<std::uint8_t>(m.getTipoMembresia());
+    r.activo = m.estaActivo() ? 1 : 0;
+    r.diasAsistencia = m.getDiasAsistencia();
+    r.nombre = nombre;
+    r.offBloques = static_cast<std::uint32_t>(bloques.size());
+    r.offDatos = static_cast<std::uint32_t>(datos.size());
+    r.ultimo = m.getHistorial().copiarCrudo(bloques, datos);
+    r.numBloques = static_cast<std::uint32_t>(bloques.size()) - r.offBloques;
+    r.tamDatos = static_cast<std::uint32_t>(datos.size()) - r.offDatos;
+    const std::vector<IdClase>& suyas = m.getClasesInscritas();
+    r.offClases = static_cast<std::uint32_t>(clasesMiembro.size());
+    r.numClases = static_cast<std::uint32_t>(suyas.size());
+    clasesMiembro.insert(clasesMiembro.end(), suyas.begin(), suyas.end());
+    r.version = m.getVersion();
+    return r;
+}
+
+CapturaSnapshot Gimnasio::capturarSnapshot(const std::function<void()>& alCerrar) const {
+    CapturaSnapshot captura;
+    std::uint64_t generacionCopiada;
+    {
+        // Primera pasada con la estructura compartida: cada miembro se copia bajo
+        // su shard y las asistencias e inscripciones siguen corriendo mientras tanto
+        std::shared_lock<std::shared_mutex> estructura(mutexEstructura);
+        generacionCopiada = generacion;
+        captura.miembros.reserve(miembros.size());
+        for (const Miembro& m : miembros) {
+            std::lock_guard<std::mutex> shard(mutexShard(m.getIdMiembro()));
+            captura.miembros.push_back(
+                captura.copiarMiembro(m, agregarCadena(captura.textos, m.getNombre())));
+        }
+    }
+
+    // Holgura para lo que haya que volver a copiar: sin ella, crecer 'datos' bajo
+    // el bloqueo exclusivo moveria todos los historiales ya copiados
+    captura.miembros.reserve(captura.miembros.size() + captura.miembros.size() / 4);
+    captura.bloques.reserve(captura.bloques.size() + captura.bloques.size() / 4);
+    captura.datos.reserve(captura.datos.size() + captura.datos.size() / 4);
+    captura.clasesMiembro.reserve(captura.clasesMiembro.size() +
+                                  captura.clasesMiembro.size() / 4);
+
+    // Segunda pasada, exclusiva: solo se vuelve a copiar lo que cambio entretanto
+    // (lo copiado antes queda sin referencias dentro de la captura) y lo que se
+    // registro despues. Clases, listas de espera y contadores son pocos y van aca.
+    std::unique_lock<std::shared_mutex> estructura(mutexEstructura);
+    if (generacion != generacionCopiada) captura = CapturaSnapshot();  // se recargo
+    const std::size_t copiados = captura.miembros.size();
+    Handle h = 0;
+    for (const Miembro& m : miembros) {
+        if (h >= copiados) {
+            captura.miembros.push_back(
+                captura.copiarMiembro(m, agregarCadena(captura.textos, m.getNombre())));
+        } else if (captura.miembros[h].version != m.getVersion()) {
+            captura.miembros[h] = captura.copiarMiembro(m, captura.miembros[h].nombre);
+        }
+        h++;
+    }
+
+    captura.clases.reserve(clases.size());
+    for (const auto& c : clases) {
+        RegistroClaseBin r{};
+        r.nombre = agregarCadena(captura.textos, c.getNombre());
+        r.instructor = agregarCadena(captura.textos, c.getInstructor());
+        r.horario = agregarCadena(captura.textos, c.getHorario());
+        r.codigo = agregarCadena(captura.textos, c.getCodigo());
+        r.capacidadMaxima = c.getCapacidadMaxima();
+        captura.clases.push_back(r);
+        c.getListaEspera().paraCada([&](int idMiembro, int prioridad, std::uint64_t orden) {
+            captura.espera.push_back({idMiembro, prioridad, orden});
+        });
+        captura.filasEspera.push_back(static_cast<std::uint32_t>(captura.espera.size()));
+    }
+
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexJournal);
+        captura.secuenciaJournal = secuenciaAplicada;
+    }
+    captura.horas = asistenciasPorHora.copiarConteos(captura.horaBase);
+    if (alCerrar) alCerrar();
+    estructura.unlock();
+
+    // Las clases de cada miembro pasan a CSR en orden de slot, ya sin bloqueo
+    captura.porMiembro.filas.reserve(captura.miembros.size() + 1);
+    captura.porMiembro.vecinos.reserve(captura.clasesMiembro.size());
+    for (const auto& m : captura.miembros) {
+        captura.porMiembro.vecinos.insert(captura.porMiembro.vecinos.end(),
+                                          captura.clasesMiembro.begin() + m.offClases,
+                                          captura.clasesMiembro.begin() + m.offClases +
+                                              m.numClases);
+        captura.porMiembro.cerrarFila();
+    }
+    std::vector<IdClase>().swap(captura.clasesMiembro);
+    return captura;
+}
+
+std::string CapturaSnapshot::armarImagen() const {
+    GrafoCSR porClase = porMiembro.transpuesto(clases.size());
+
+    std::vector<RegistroMiembroBin> registros;
+    registros.reserve(miembros.size());
+    std::string historiales;
+    for (const MiembroCrudo& m : miembros) {
+        RegistroMiembroBin r{};
+        r.idMiembro = m.idMiembro;
+        r.nombre = m.nombre;
+        r.diasAsistencia = m.diasAsistencia;
+        r.activo = m.activo;
+        r.tipoMembresia = m.tipoMembresia;
+        r.historial.offset = static_cast<std::uint32_t>(historiales.size());
+        SerieTemporal::serializarCrudo(historiales, bloques.data() + m.offBloques, m.numBloques,
+                                       datos.data() + m.offDatos, m.tamDatos, m.ultimo);
+        r.historial.largo = static_cast<std::uint32_t>(historiales.size() - r.historial.offset);
+        registros.push_back(r);
+    }
+
+    CabeceraSnapshot cab{};
+    std::memcpy(cab.magia, MAGIA_SNAPSHOT, sizeof(cab.magia));
+    cab.version = VERSION_SNAPSHOT;
+    cab.secuenciaJournal = secuenciaJournal;
+    cab.horaBase = horaBase;
+    cab.numMiembros = static_cast<std::uint32_t>(miembros.size());
+    cab.numClases = static_cast<std::uint32_t>(clases.size());
+    cab.tamCadenas = static_cast<std::uint32_t>(textos.size());
+    cab.offMiembros = sizeof(CabeceraSnapshot);
+    cab.offClases = cab.offMiembros + registros.size() * sizeof(RegistroMiembroBin);
+    cab.offCadenas = cab.offClases + clases.size() * sizeof(RegistroClaseBin);
+    cab.offHistorial = cab.offCadenas + textos.size();
+    cab.tamHistorial = historiales.size();
+    cab.offHoras = cab.offHistorial + historiales.size();
+    cab.numHoras = horas.size();
+    cab.offInscripciones = cab.offHoras + horas.size() * sizeof(std::uint32_t);
+    cab.numAristas = porClase.aristas();
+    cab.offEspera = cab.offInscripciones +
+                    (porClase.filas.size() + porMiembro.filas.size() + 2 * cab.numAristas) *
+                        sizeof(std::uint32_t);
+    cab.numEspera = espera.size();
+    auto agregarArreglo = [](std::string& destino, const std::vector<std::uint32_t>& v) {
+        destino.append(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(std::uint32_t));
+    };
+
+    // Se arma la imagen completa en memoria; quien llama la escribe en una sola pasada
+    std::string imagen;
+    imagen.reserve(cab.offEspera + filasEspera.size() * sizeof(std::uint32_t) +
+                   espera.size() * sizeof(EntradaEsperaBin));
+    imagen.append(reinterpret_cast<const char*>(&cab), sizeof(cab));
+    imagen.append(reinterpret_cast<const char*>(registros.data()),
+                  registros.size() * sizeof(RegistroMiembroBin));
+    imagen.append(reinterpret_cast<const char*>(clases.data()),
+                  clases.size() * sizeof(RegistroClaseBin));
+    imagen += textos;
+    imagen += historiales;
+    agregarArreglo(imagen, horas);
+    agregarArreglo(imagen, porClase.filas);
+    agregarArreglo(imagen, porClase.vecinos);
+    agregarArreglo(imagen, porMiembro.filas);
+    agregarArreglo(imagen, porMiembro.vecinos);
+    agregarArreglo(imagen, filasEspera);
+    imagen.append(reinterpret_cast<const char*>(espera.data()),
+                  espera.size() * sizeof(EntradaEsperaBin));
+    return imagen;
+}
+
+bool Gimnasio::cargarSnapshot(const std::string& archivo, bool informar) {
+    ArchivoMapeado mapa(archivo);
+    if (!mapa.valido() || mapa.size() < sizeof(CabeceraSnapshot)) {
+        return false;
+    }
+
+    CabeceraSnapshot cab;
+    std::memcpy(&cab, mapa.data(), sizeof(cab));
+    if (std::memcmp(cab.magia, MAGIA_SNAPSHOT, sizeof(cab.magia)) != 0 ||
+        cab.version != VERSION_SNAPSHOT) {
+        std::cout << "ERROR: '" << archivo << "' no es un snapshot compatible.\n";
+        return false;
+    }
+
+    // Cada seccion empieza despues de la anterior y cabe en el archivo. Las
+    // cantidades se comparan contra el espacio que queda antes de multiplicar:
+    // un encabezado adulterado no puede desbordar la cuenta.
+    std::uint64_t fin = sizeof(CabeceraSnapshot);
+    auto seccion = [&](std::uint64_t offset, std::uint64_t cantidad, std::uint64_t tamElemento) {
+        if (offset < fin || offset > mapa.size() ||
+            cantidad > (mapa.size() - offset) / tamElemento) {
+            return false;
+        }
+        fin = offset + cantidad * tamElemento;
+        return true;
+    };
+    if (!seccion(cab.offMiembros, cab.numMiembros, sizeof(RegistroMiembroBin)) ||
+        !seccion(cab.offClases, cab.numClases, sizeof(RegistroClaseBin)) ||
+        !seccion(cab.offCadenas, cab.tamCadenas, 1) ||
+        !seccion(cab.offHistorial, cab.tamHistorial, 1) ||
+        !seccion(cab.offHoras, cab.numHoras, sizeof(std::uint32_t)) ||
+        !seccion(cab.offInscripciones, std::uint64_t(cab.numClases) + 1, sizeof(std::uint32_t)) ||
+        !seccion(fin, cab.numAristas, sizeof(std::uint32_t)) ||
+        !seccion(fin, std::uint64_t(cab.numMiembros) + 1, sizeof(std::uint32_t)) ||
+        !seccion(fin, cab.numAristas, sizeof(std::uint32_t)) ||
+        !seccion(cab.offEspera, std::uint64_t(cab.numClases) + 1, sizeof(std::uint32_t)) ||
+        !seccion(fin, cab.numEspera, sizeof(EntradaEsperaBin))) {
+        std::cout << "ERROR: Snapshot '" << archivo << "' truncado o corrupto.\n";
+        return false;
+    }
+
+    const char* cadenas = mapa.data() + cab.offCadenas;
+    auto texto = [&](const RefCadena& ref) {
+        if (std::uint64_t(ref.offset) + ref.largo > cab.tamCadenas) return std::string();
+        return std::string(cadenas + ref.offset, ref.largo);
+    };
+
+    MedicionOperacion medir(metricas, OperacionMedida::Carga);
+    const EstadisticasMemoria memoriaInicial = estadisticasMemoria();
+    std::unique_lock<std::shared_mutex> bloqueo(mutexEstructura);
+    miembros.clear();
+    clases.clear();
+    generacion++;
+    secuenciaAplicada = cab.secuenciaJournal;
+    {
+        std::lock_guard<std::mutex> bloqueoJournal(mutexJournal);
+        secuenciaSnapshot = cab.secuenciaJournal;
+    }
+    miembros.reserve(cab.numMiembros);
+    clases.reserve(cab.numClases);
+    std::vector<Handle> handleMiembro(cab.numMiembros, HANDLE_INVALIDO);
+    std::vector<Handle> handleClase(cab.numClases, HANDLE_INVALIDO);
+    std::size_t historialesCorruptos = 0;
+
+    for (std::uint32_t i = 0; i < cab.numMiembros; i++) {
+        RegistroMiembroBin r;
+        std::memcpy(&r, mapa.data() + cab.offMiembros + i * sizeof(r), sizeof(r));
+        if (r.tipoMembresia >= static_cast<std::uint8_t>(TipoMembresia::Cantidad)) continue;
+        Handle h = miembros.insertar(r.idMiembro, texto(r.nombre), r.idMiembro,
+                                     static_cast<TipoMembresia>(r.tipoMembresia));
+        if (h == HANDLE_INVALIDO) continue;
+        handleMiembro[i] = h;
+        Miembro& m = miembros.obtener(h);
+        m.setMembresiaActiva(r.activo != 0);
+        m.setDiasAsistencia(r.diasAsistencia);
+        if (std::uint64_t(r.historial.offset) + r.historial.largo > cab.tamHistorial ||
+            !m.getHistorial().deserializar(mapa.data() + cab.offHistorial + r.historial.offset,
+                                           r.historial.largo)) {
+            historialesCorruptos++;
+        }
+    }
+    if (historialesCorruptos > 0) {
+        std::cout << "ADVERTENCIA: " << historialesCorruptos << " historial(es) del snapshot "
+                  << "corrupto(s); esos miembros quedan sin historial.\n";
+    }
+    std::vector<std::uint32_t> horas(cab.numHoras);
+    if (!horas.empty()) {
+        std::memcpy(horas.data(), mapa.data() + cab.offHoras,
+                    horas.size() * sizeof(std::uint32_t));
+    }
+    asistenciasPorHora.cargar(cab.horaBase, horas.data(), horas.size());
+
+    for (std::uint32_t i = 0; i < cab.numClases; i++) {
+        RegistroClaseBin r;
+        std::memcpy(&r, mapa.data() + cab.offClases + i * sizeof(r), sizeof(r));
+        std::string codigo = texto(r.codigo);
+        handleClase[i] = clases.insertar(codigo, texto(r.nombre), texto(r.instructor),
+                                         texto(r.horario), codigo, r.capacidadMaxima);
+    }
+
+    // Inscripciones: cuatro copias contiguas desde el mapeo, sin tocar arista por arista
+    const char* p = mapa.data() + cab.offInscripciones;
+    auto leerArreglo = [&p](std::vector<std::uint32_t>& destino, std::size_t n) {
+        destino.resize(n);
+        if (n > 0) std::memcpy(destino.data(), p, n * sizeof(std::uint32_t));
+        p += n * sizeof(std::uint32_t);
+    };
+    GrafoCSR porClase, porMiembro;
+    leerArreglo(porClase.filas, std::size_t(cab.numClases) + 1);
+    leerArreglo(porClase.vecinos, cab.numAristas);
+    leerArreglo(porMiembro.filas, std::size_t(cab.numMiembros) + 1);
+    leerArreglo(porMiembro.vecinos, cab.numAristas);
+    if (porClase.valido() && porMiembro.valido()) {
+        cargarInscripciones(porClase, porMiembro, handleMiembro, handleClase);
+    } else {
+        std::cout << "ADVERTENCIA: Inscripciones del snapshot corruptas; se omiten.\n";
+    }
+
+    // Listas de espera: cada entrada vuelve con su prioridad y orden de llegada
+    std::vector<std::uint32_t> filasEspera;
+    p = mapa.data() + cab.offEspera;
+    leerArreglo(filasEspera, std::size_t(cab.numClases) + 1);
+    if (filasEspera.front() == 0 && filasEspera.back() == cab.numEspera &&
+        std::is_sorted(filasEspera.begin(), filasEspera.end())) {
+        for (std::uint32_t c = 0; c < cab.numClases; c++) {
+            if (handleClase[c] == HANDLE_INVALIDO) continue;
+            ClaseGym& clase = clases.obtener(handleClase[c]);
+            for (std::uint32_t i = filasEspera[c]; i < filasEspera[c + 1]; i++) {
+                EntradaEsperaBin e;
+                std::memcpy(&e, p + i * sizeof(e), sizeof(e));
+                if (miembros.buscar(e.idMiembro) != HANDLE_INVALIDO &&
+                    !clase.estaMiembroInscrito(e.idMiembro)) {
+                    clase.getListaEspera().restaurar(e.idMiembro, e.prioridad, e.orden);
+                }
+            }
+        }
+    } else {
+        std::cout << "ADVERTENCIA: Listas de espera del snapshot corruptas; se omiten.\n";
+    }
+    reconstruirAgregados();
+
+    if (informar) {
+        std::cout << "✅ Snapshot cargado: " << miembros.size() << " miembros, "
+                  << clases.size() << " clases (" << estadisticasMemoria() - memoriaInicial
+                  << ")\n";
+    }
+    medir(CodigoResultado::Ok);
+    return true;
+}
+
+// =================================================================================
+// JOURNAL (BITACORA DE CAMBIOS)
+// =================================================================================
+
+void Gimnasio::aplicarRegistro(TipoRegistro tipo, LectorRegistro& lector) {
+    IdClase idClase = HANDLE_INVALIDO;
+    switch (tipo) {
+        case TipoRegistro::RegistrarMiembro: {
+            int id = lector.entero();
+            std::string nombreMiembro = lector.texto();
+            TipoMembresia tipoMembresia;
+            if (lector.ok() && parsearTipoMembresia(lector.texto(), tipoMembresia)) {
+                ejecutarRegistroMiembro(nombreMiembro, id, tipoMembresia);
+            }
+            break;
+        }
+        case TipoRegistro::CrearClase: {
+            std::string nombreClase = lector.texto();
+            std::string instructor = lector.texto();
+            std::string horario = lector.texto();
+            std::string codigo = lector.texto();
+            int capacidad = lector.entero();
+            if (lector.ok()) {
+                ejecutarCreacionClase(nombreClase, instructor, horario, codigo, capacidad);
+            }
+            break;
+        }
+        case TipoRegistro::Asistencia: {
+            int id = lector.entero();
+            std::int64_t momento = lector.quedanDatos() ? lector.entero64() : momentoActual();
+            if (lector.ok()) ejecutarAsistencia(id, momento);
+            break;
+        }
+        case TipoRegistro::Inscripcion: {
+            int id = lector.entero();
+            std::string codigo = lector.texto();
+            if (lector.ok()) aplicarInscripcion(id, codigo, idClase);
+            break;
+        }
+        case TipoRegistro::Cancelacion: {
+            int id = lector.entero();
+            std::string codigo = lector.texto();
+            if (lector.ok()) aplicarCancelacion(id, codigo, idClase);
+            break;
+        }
+        case TipoRegistro::Promocion: {
+            int id = lector.entero();
+            IdClase idClase = clases.buscar(lector.texto());
+            if (lector.ok() && idClase != HANDLE_INVALIDO) aplicarPromocion(id, idClase);
+            break;
+        }
+        case TipoRegistro::CambioEstado: {
+            int id = lector.entero();
+            int activa = lector.entero();
+            if (lector.ok()) ejecutarCambioEstado(id, activa != 0);
+            break;
+        }
+        case TipoRegistro::AsistenciaLote: {
+            int cantidad = lector.entero();
+            std::vector<int> ids;
+            ids.reserve(std::max(cantidad, 0));
+            for (int i = 0; i < cantidad && lector.ok(); i++) ids.push_back(lector.entero());
+            std::int64_t momento = lector.quedanDatos() ? lector.entero64() : momentoActual();
+            if (lector.ok()) {
+                std::vector<CodigoResultado> resultados(ids.size());
+                ejecutarAsistenciasLote(ids.data(), ids.size(), resultados.data(), momento);
+            }
+            break;
+        }
+    }
+}
+
+bool Gimnasio::activarJournal(const std::string& ruta, const ConfigJournal& config) {
+    // Mientras se reproduce no hay journal abierto, asi nada se vuelve a anotar
+    journal.reset();
+    int reproducidas = 0;
+    metricas.setActiva(false);  // lo reproducido no es trafico de esta sesion
+    auto aplicar = [&](std::uint64_t secuencia, TipoRegistro tipo, LectorRegistro& lector) {
+        if (secuencia <= secuenciaAplicada) return;  // ya incluida en el snapshot
+        aplicarRegistro(tipo, lector);
+        secuenciaAplicada = secuencia;
+        reproducidas++;
+    };
+    // El segmento anterior existe si un checkpoint no llego a borrarlo
+    Journal::reproducir(Journal::rutaAnterior(ruta), aplicar);
+    Journal::reproducir(ruta, aplicar);
+    metricas.setActiva(true);
+
+    auto nuevo = std::make_unique<Journal>();
+    if (!nuevo->abrir(ruta, config, secuenciaAplicada)) {
+        std::cout << "ERROR: No se pudo abrir el journal " << ruta << "\n";
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexJournal);
+        journal = std::move(nuevo);
+    }
+    if (reproducidas > 0) {
+        std::cout << "✅ Journal: " << reproducidas << " operaciones recuperadas\n";
+    }
+    return true;
+}
+
+void Gimnasio::confirmarCambios() {
+    std::lock_guard<std::mutex> bloqueo(mutexJournal);
+    if (journal) journal->confirmar();
+}
+
+bool Gimnasio::checkpoint(const std::string& archivoSnapshot, bool informar) {
+    // El snapshot registra la secuencia capturada: si se cae antes de borrar el
+    // segmento viejo del journal, la reproduccion salta lo que el snapshot ya
+    // contiene. Lo que se anote mientras se escribe va al segmento nuevo.
+    MedicionOperacion medir(metricas, OperacionMedida::Guardado);
+    std::lock_guard<std::mutex> serie(mutexSnapshot);
+    int segmentoViejo = -1;
+    std::string rutaJournal;
+    const CapturaSnapshot captura = capturarSnapshot([&]() {
+        // Con la estructura exclusiva nadie anota: el segmento que se cierra
+        // termina justo en la secuencia capturada
+        std::lock_guard<std::mutex> bloqueo(mutexJournal);
+        if (journal) {
+            segmentoViejo = journal->rotar();
+            rutaJournal = journal->getRuta();
+        }
+    });
+    const std::string imagen = captura.armarImagen();
+
+    const bool escrito = escribirArchivoAtomico(archivoSnapshot, imagen.data(), imagen.size());
+    if (segmentoViejo >= 0) {
+        if (!escrito) ::fsync(segmentoViejo);  // sus registros siguen haciendo falta
+        ::close(segmentoViejo);
+    }
+    if (!escrito) {
+        std::cout << "ERROR: No se pudo escribir el snapshot " << archivoSnapshot << "\n";
+        return false;
+    }
+    // Todo lo del segmento anterior ya esta en el snapshot
+    if (!rutaJournal.empty() && ::unlink(Journal::rutaAnterior(rutaJournal).c_str()) != 0 &&
+        errno != ENOENT) {
+        std::cout << "ERROR: No se pudo borrar el segmento anterior del journal.\n";
+    }
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexJournal);
+        secuenciaSnapshot = captura.secuenciaJournal;
+    }
+    if (informar) {
+        std::cout << "\n✅ Snapshot guardado en '" << archivoSnapshot << "' ("
+                  << imagen.size() << " bytes)\n";
+    }
+    medir(CodigoResultado::Ok);
+    return true;
+}
+
+std::uint64_t Gimnasio::cambiosSinSnapshot() const {
+    std::lock_guard<std::mutex> bloqueo(mutexJournal);
+    return secuenciaAplicada - secuenciaSnapshot;
+}
+
+// =================================================================================
+// ARCHIVO: Autoguardado.h
+// RESPONSABILIDAD: Checkpoints en segundo plano por tiempo o cantidad de cambios
+// =================================================================================
+
+struct ConfigAutoguardado {
+    std::chrono::seconds intervalo{300};  // guarda si hay cambios y paso este tiempo
+    std::uint64_t cambiosMaximos = 10000;  // o en cuanto se juntan tantos cambios
+};
+
+// Hilo propio que hace checkpoint del gimnasio cuando toca o cuando se le pide.
+// Los cambios se cuentan por el journal: sin journal activo no se dispara solo.
+class Autoguardado {
+private:
+    static constexpr std::chrono::seconds REVISION{1};
+
+    Gimnasio& gimnasio;
+    std::string archivoSnapshot;
+    ConfigAutoguardado config;
+    std::mutex mutex;
+    std::condition_variable despertar;
+    bool detener;
+    bool solicitado;
+    std::thread hilo;  // ultimo: arranca con el resto ya construido
+
+    void ejecutar();
+
+public:
+    Autoguardado(Gimnasio& gimnasio, const std::string& archivoSnapshot,
+                 const ConfigAutoguardado& config = ConfigAutoguardado());
+    ~Autoguardado();  // espera a que termine el guardado en curso
+    Autoguardado(const Autoguardado&) = delete;
+    Autoguardado& operator=(const Autoguardado&) = delete;
+
+    // Pide un checkpoint inmediato sin esperarlo; avisa por consola al terminar
+    void solicitar();
+};
+
+// =================================================================================
+// ARCHIVO: Autoguardado.cpp
+// =================================================================================
+
+Autoguardado::Autoguardado(Gimnasio& gimnasio, const std::string& archivoSnapshot,
+                           const ConfigAutoguardado& config)
+    : gimnasio(gimnasio), archivoSnapshot(archivoSnapshot), config(config), detener(false),
+      solicitado(false), hilo(&Autoguardado::ejecutar, this) {}
+
+Autoguardado::~Autoguardado() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        detener = true;
+    }
+    despertar.notify_one();
+    hilo.join();
+}
+
+void Autoguardado::solicitar() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        solicitado = true;
+    }
+    despertar.notify_one();
+}
+
+void Autoguardado::ejecutar() {
+    auto ultimo = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> bloqueo(mutex);
+    while (!detener) {
+        despertar.wait_for(bloqueo, REVISION, [this] { return detener || solicitado; });
+        if (detener) break;
+
+        const bool manual = solicitado;
+        const std::uint64_t cambios = gimnasio.cambiosSinSnapshot();
+        const bool vencido = std::chrono::steady_clock::now() - ultimo >= config.intervalo;
+        if (!manual && cambios < config.cambiosMaximos && !(cambios > 0 && vencido)) continue;
+
+        solicitado = false;
+        bloqueo.unlock();
+        gimnasio.checkpoint(archivoSnapshot, manual);
+        bloqueo.lock();
+        ultimo = std::chrono::steady_clock::now();
+    }
+}
+
+// =================================================================================
+// ARCHIVO: Federacion.h
+// RESPONSABILIDAD: Varias sedes (un Gimnasio cada una) en un solo proceso
+// =================================================================================
+
+// Una sede por linea del archivo de configuracion: "nombre|rutaBase". Sus datos
+// viven en rutaBase.snap / rutaBase.txt / rutaBase.journal.
+struct ConfigSede {
+    std::string nombre;
+    std::string rutaBase;
+};
+
+// Lee el archivo de sedes; lineas vacias y las que empiezan con '#' se ignoran.
+// false si no se pudo leer, hay lineas invalidas o nombres repetidos.
+bool leerConfigSedes(const std::string& archivo, std::vector<ConfigSede>& sedes);
+
+// Un hilo con su cola FIFO de tareas; al destruirse termina las pendientes
+class TrabajadorSede {
+private:
+    std::mutex mutex;
+    std::condition_variable hayTareas;
+    std::deque<std::function<void()>> tareas;
+    bool detener;
+    std::thread hilo;  // ultimo: arranca con el resto ya construido
+
+    void ejecutar();
+
+public:
+    TrabajadorSede();
+    ~TrabajadorSede();
+    TrabajadorSede(const TrabajadorSede&) = delete;
+    TrabajadorSede& operator=(const TrabajadorSede&) = delete;
+
+    template <typename Funcion>
+    auto enviar(Funcion funcion) -> std::future<decltype(funcion())> {
+        using Resultado = decltype(funcion());
+        auto tarea = std::make_shared<std::packaged_task<Resultado()>>(std::move(funcion));
+        std::future<Resultado> futuro = tarea->get_future();
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            tareas.emplace_back([tarea] { (*tarea)(); });
+        }
+        hayTareas.notify_one();
+        return futuro;
+    }
+};
+
+struct ResumenSede {
+    ResumenDiario diario;
+    ResumenPorMembresia porMembresia;
+    std::uint64_t visitasExternas;  // asistencias de miembros de otras sedes (sesion)
+};
+
+struct ResumenCadena {
+    std::vector<ResumenSede> porSede;  // mismo orden que las sedes
+    ResumenSede total;
+};
+
+// Cada sede es una particion independiente con su propio hilo trabajador.
+// El trabajo de sede completa (carga, resumenes, checkpoint) se reparte entre los
+// trabajadores y corre en paralelo. Las operaciones puntuales corren en el hilo que
+// llama: Gimnasio ya es seguro entre hilos y pasar por la cola solo sumaria latencia.
+//
+// El directorio global (id de miembro -> sede de origen) mantiene los IDs unicos en
+// toda la cadena y permite registrar la asistencia en cualquier sede: se aplica
+// sobre la sede de origen, que es la duena del estado del miembro.
+class Federacion {
+private:
+    struct Sede {
+        ConfigSede config;
+        std::unique_ptr<Gimnasio> gimnasio;
+        std::atomic<std::uint64_t> visitasExternas{0};
+        TrabajadorSede trabajador;  // se destruye (y espera) antes que el gimnasio
+    };
+
+    std::vector<std::unique_ptr<Sede>> sedes;
+    std::unordered_map<int, std::uint32_t> directorio;
+    mutable std::shared_mutex mutexDirectorio;
+
+public:
+    explicit Federacion(const std::vector<ConfigSede>& config);
+
+    std::size_t numSedes() const { return sedes.size(); }
+    const std::string& nombreSede(std::size_t sede) const { return sedes[sede]->config.nombre; }
+    Gimnasio& getGimnasio(std::size_t sede) { return *sedes[sede]->gimnasio; }
+
+    // Carga todas las sedes en paralelo, activa sus journals y arma el directorio.
+    // Un ID presente en varias sedes queda asignado a la primera.
+    void cargar();
+
+    // Sede de origen del miembro; -1 si no existe en ninguna
+    int sedeDeOrigen(int idMiembro) const;
+
+    // 'sede' (y 'sedeVisitada') deben ser menores que numSedes()
+    CodigoResultado registrarMiembro(std::size_t sede, const std::string& nombre,
+                                     int idMiembro, TipoMembresia tipo);
+    CodigoResultado registrarAsistencia(std::size_t sedeVisitada, int idMiembro);
+
+    ResumenCadena resumir() const;
+    void mostrarResumenCadena() const;
+
+    void confirmarCambios();
+    // Checkpoint de todas las sedes en paralelo; devuelve cuantas lo lograron
+    std::size_t checkpoint();
+};
+
+// =================================================================================
+// ARCHIVO: Federacion.cpp
+// =================================================================================
+
+bool leerConfigSedes(const std::string& archivo, std::vector<ConfigSede>& sedes) {
+    std::ifstream entrada(archivo);
+    if (!entrada.is_open()) {
+        std::cout << "ERROR: No se pudo leer el archivo de sedes " << archivo << "\n";
+        return false;
+    }
+    sedes.clear();
+    std::string linea;
+    for (std::size_t numero = 1; std::getline(entrada, linea); numero++) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (linea.empty() || linea[0] == '#') continue;
+        std::size_t separador = linea.find('|');
+        if (separador == std::string::npos || separador == 0 || separador + 1 == linea.size()) {
+            std::cout << "ERROR: Linea " << numero << " de " << archivo
+                      << ": se esperaba 'nombre|rutaBase'.\n";
+            return false;
+        }
+        ConfigSede sede{linea.substr(0, separador), linea.substr(separador + 1)};
+        for (const ConfigSede& otra : sedes) {
+            if (otra.nombre == sede.nombre) {
+                std::cout << "ERROR: Sede '" << sede.nombre << "' repetida en la linea "
+                          << numero << ".\n";
+                return false;
+            }
+        }
+        sedes.push_back(std::move(sede));
+    }
+    if (sedes.empty()) {
+        std::cout << "ERROR: " << archivo << " no define ninguna sede.\n";
+        return false;
+    }
+    return true;
+}
+
+TrabajadorSede::TrabajadorSede() : detener(false), hilo(&TrabajadorSede::ejecutar, this) {}
+
+TrabajadorSede::~TrabajadorSede() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        detener = true;
+    }
+    hayTareas.notify_one();
+    hilo.join();
+}
+
+void TrabajadorSede::ejecutar() {
+    std::unique_lock<std::mutex> bloqueo(mutex);
+    while (true) {
+        hayTareas.wait(bloqueo, [this] { return detener || !tareas.empty(); });
+        if (tareas.empty()) return;  // detener sin pendientes
+        std::function<void()> tarea = std::move(tareas.front());
+        tareas.pop_front();
+        bloqueo.unlock();
+        tarea();
+        bloqueo.lock();
+    }
+}
+
+Federacion::Federacion(const std::vector<ConfigSede>& config) {
+    sedes.reserve(config.size());
+    for (const ConfigSede& c : config) {
+        auto sede = std::make_unique<Sede>();
+        sede->config = c;
+        sede->gimnasio = std::make_unique<Gimnasio>(c.nombre);
+        sedes.push_back(std::move(sede));
+    }
+}
+
+void Federacion::cargar() {
+    std::vector<std::future<std::vector<int>>> pendientes;
+    pendientes.reserve(sedes.size());
+    for (auto& sede : sedes) {
+        Sede* s = sede.get();
+        pendientes.push_back(s->trabajador.enviar([s] {
+            const std::string& base = s->config.rutaBase;
+            if (!s->gimnasio->cargarSnapshot(base + ".snap")) {
+                s->gimnasio->cargarDatos(base + ".txt");
+            }
+            s->gimnasio->activarJournal(base + ".journal");
+            return s->gimnasio->idsMiembros();
+        }));
+    }
+    std::vector<std::vector<int>> idsPorSede;
+    idsPorSede.reserve(sedes.size());
+    std::size_t total = 0;
+    for (auto& pendiente : pendientes) {
+        idsPorSede.push_back(pendiente.get());
+        total += idsPorSede.back().size();
+    }
+
+    std::unique_lock<std::shared_mutex> bloqueo(mutexDirectorio);
+    directorio.clear();
+    directorio.reserve(total);
+    std::size_t duplicados = 0;
+    for (std::uint32_t s = 0; s < idsPorSede.size(); s++) {
+        for (int id : idsPorSede[s]) {
+            auto insercion = directorio.emplace(id, s);
+            if (!insercion.second && ++duplicados <= 10) {
+                std::cout << "ADVERTENCIA: ID " << id << " existe en '"
+                          << sedes[insercion.first->second]->config.nombre << "' y en '"
+                          << sedes[s]->config.nombre << "'; se usa la primera.\n";
+            }
+        }
+    }
+    if (duplicados > 10) {
+        std::cout << "ADVERTENCIA: " << duplicados << " IDs repetidos entre sedes en total.\n";
+    }
+    std::cout << "✅ Federacion cargada: " << sedes.size() << " sedes, "
+              << directorio.size() << " miembros en el directorio\n";
+}
+
+int Federacion::sedeDeOrigen(int idMiembro) const {
+    std::shared_lock<std::shared_mutex> bloqueo(mutexDirectorio);
+    auto it = directorio.find(idMiembro);
+    return it != directorio.end() ? static_cast<int>(it->second) : -1;
+}
 
-public:
-    ClaseGym(const std::string& nombre, const std::string& instructor,
-             const std::string& horario, const std::string& codigo, int capacidad);
+CodigoResultado Federacion::registrarMiembro(std::size_t sede, const std::string& nombre,
+                                             int idMiembro, TipoMembresia tipo) {
+    // El ID se reserva en el directorio antes del alta, asi dos sedes no pueden
+    // registrar el mismo ID a la vez
+    {
+        std::unique_lock<std::shared_mutex> bloqueo(mutexDirectorio);
+        if (!directorio.emplace(idMiembro, static_cast<std::uint32_t>(sede)).second) {
+            return CodigoResultado::IdDuplicado;
+        }
+    }
+    CodigoResultado resultado =
+        sedes[sede]->gimnasio->ejecutarRegistroMiembro(nombre, idMiembro, tipo);
+    if (resultado != CodigoResultado::Ok) {
+        std::unique_lock<std::shared_mutex> bloqueo(mutexDirectorio);
+        directorio.erase(idMiembro);
+    }
+    return resultado;
+}
 
-    // Getters
-    std::string getNombre() const { return nombreClase; }
-    std::string getInstructor() const { return instructor; }
-    std::string getHorario() const { return horario; }
-    std::string getCodigo() const { return codigoClase; }
-    int getCapacidadMaxima() const { return capacidadMaxima; }
-    int getInscritos() const { return inscritos; }
-    bool tieneCupo() const { return inscritos < capacidadMaxima; }
+CodigoResultado Federacion::registrarAsistencia(std::size_t sedeVisitada, int idMiembro) {
+    int origen = sedeDeOrigen(idMiembro);
+    if (origen < 0) return CodigoResultado::MiembroNoEncontrado;
+    CodigoResultado resultado = sedes[origen]->gimnasio->ejecutarAsistencia(idMiembro);
+    if (resultado == CodigoResultado::Ok && static_cast<std::size_t>(origen) != sedeVisitada) {
+        sedes[sedeVisitada]->visitasExternas.fetch_add(1, std::memory_order_relaxed);
+    }
+    return resultado;
+}
 
-    // Métodos de operación
-    bool inscribirMiembro(int idMiembro);
-    bool cancelarInscripcion(int idMiembro);
-    bool estaMiembroInscrito(int idMiembro) const;
-    void mostrarInformacion() const;
-};
+ResumenCadena Federacion::resumir() const {
+    std::vector<std::future<ResumenSede>> pendientes;
+    pendientes.reserve(sedes.size());
+    for (const auto& sede : sedes) {
+        Sede* s = sede.get();
+        pendientes.push_back(s->trabajador.enviar([s] {
+            return ResumenSede{s->gimnasio->obtenerResumenDiario(),
+                               s->gimnasio->obtenerResumenPorMembresia(),
+                               s->visitasExternas.load(std::memory_order_relaxed)};
+        }));
+    }
+
+    ResumenCadena cadena;
+    cadena.porSede.reserve(sedes.size());
+    cadena.total = ResumenSede{};
+    ResumenSede& t = cadena.total;
+    for (auto& pendiente : pendientes) {
+        cadena.porSede.push_back(pendiente.get());
+        const ResumenSede& r = cadena.porSede.back();
+        t.diario.miembros += r.diario.miembros;
+        t.diario.clases += r.diario.clases;
+        t.diario.asistenciasHoy += r.diario.asistenciasHoy;
+        t.diario.asistenciasAyer += r.diario.asistenciasAyer;
+        t.diario.cuposOcupados += r.diario.cuposOcupados;
+        t.diario.cuposTotales += r.diario.cuposTotales;
+        for (std::size_t k = 0; k < t.porMembresia.size(); k++) {
+            t.porMembresia[k].miembros += r.porMembresia[k].miembros;
+            t.porMembresia[k].activos += r.porMembresia[k].activos;
+            t.porMembresia[k].asistencias += r.porMembresia[k].asistencias;
+        }
+        t.visitasExternas += r.visitasExternas;
+    }
+    return cadena;
+}
+
+void Federacion::mostrarResumenCadena() const {
+    ResumenCadena cadena = resumir();
+    auto fila = [](const std::string& nombre, const ResumenSede& r) {
+        std::cout << std::left << std::setw(20) << nombre << std::right
+                  << std::setw(10) << r.diario.miembros << std::setw(8) << r.diario.clases
+                  << std::setw(8) << r.diario.asistenciasHoy
+                  << std::setw(8) << r.diario.asistenciasAyer
+                  << std::setw(14) << (std::to_string(r.diario.cuposOcupados) + "/" +
+                                       std::to_string(r.diario.cuposTotales))
+                  << std::setw(10) << r.visitasExternas << "\n";
+    };
+
+    std::cout << "\n************** RESUMEN DE LA CADENA **************\n"
+              << std::left << std::setw(20) << "Sede" << std::right << std::setw(10)
+              << "Miembros" << std::setw(8) << "Clases" << std::setw(8) << "Hoy"
+              << std::setw(8) << "Ayer" << std::setw(14) << "Cupos" << std::setw(10)
+              << "Externas" << "\n";
+    for (std::size_t s = 0; s < sedes.size(); s++) {
+        fila(sedes[s]->config.nombre, cadena.porSede[s]);
+    }
+    fila("TOTAL", cadena.total);
+
+    std::cout << "\nPor membresia (miembros / activos / asistencias):\n";
+    for (std::size_t k = 0; k < cadena.total.porMembresia.size(); k++) {
+        const ResumenColumnas& r = cadena.total.porMembresia[k];
+        std::cout << "  " << std::left << std::setw(8) << POLITICAS_MEMBRESIA[k].nombre
+                  << std::right << std::setw(10) << r.miembros << std::setw(10) << r.activos
+                  << std::setw(12) << r.asistencias << "\n";
+    }
+    std::cout << "**************************************************\n";
+}
+
+void Federacion::confirmarCambios() {
+    for (auto& sede : sedes) sede->gimnasio->confirmarCambios();
+}
+
+std::size_t Federacion::checkpoint() {
+    std::vector<std::future<bool>> pendientes;
+    pendientes.reserve(sedes.size());
+    for (auto& sede : sedes) {
+        Sede* s = sede.get();
+        pendientes.push_back(s->trabajador.enviar(
+            [s] { return s->gimnasio->checkpoint(s->config.rutaBase + ".snap"); }));
+    }
+    std::size_t exitosas = 0;
+    for (std::size_t s = 0; s < pendientes.size(); s++) {
+        if (pendientes[s].get()) {
+            exitosas++;
+        } else {
+            std::cout << "ERROR: No se pudo guardar la sede '" << sedes[s]->config.nombre
+                      << "'.\n";
+        }
+    }
+    return exitosas;
+}
 
 // =================================================================================
-// ARCHIVO: Miembro.h
-// RESPONSABILIDAD: Representa un miembro del gimnasio
+// ARCHIVO: Benchmark.h
+// RESPONSABILIDAD: Generador de carga sintetica y medicion de las operaciones
 // =================================================================================
 
-class Miembro {
-private:
-    std::string nombre;
-    int idMiembro;
-    std::string tipoMembresia;
-    bool membresiaActiva;
-    int diasAsistencia;
-    std::vector<std::string> clasesInscritas;
+struct ConfigBenchmark {
+    int miembros = 100000;
+    int clases = 1000;
+    int operaciones = 200000;        // por cada operacion medida
+    int capacidadClase = 40;
+    double mezclaMembresias[3] = {60, 30, 10};  // peso de Basica/Premium/VIP
+    double sesgoInscripcion = 1.0;   // exponente Zipf sobre clases (0 = uniforme)
+    int repeticionesPersistencia = 3;  // de cada paso de persistencia
+    unsigned semilla = 42;
+};
 
-public:
-    Miembro(const std::string& nombre, int idMiembro, const std::string& tipoMembresia);
+struct ResultadoBenchmark {
+    std::string operacion;
+    std::size_t muestras;
+    double segundos;
+    double p50Ns;
+    double p99Ns;
+};
 
-    // Getters
-    std::string getNombre() const { return nombre; }
-    int getIdMiembro() const { return idMiembro; }
-    std::string getTipoMembresia() const { return tipoMembresia; }
-    bool estaActivo() const { return membresiaActiva; }
-    int getDiasAsistencia() const { return diasAsistencia; }
+class Benchmark {
+private:
+    ConfigBenchmark config;
+    std::vector<ResultadoBenchmark> resultados;
 
-    // Setters
-    void setMembresiaActiva(bool estado) { membresiaActiva = estado; }
-    void setTipoMembresia(const std::string& tipo) { tipoMembresia = tipo; }
+    void agregarResultado(const std::string& operacion, std::vector<std::uint64_t>& latencias,
+                          double segundos);
 
-    // Métodos de operación
-    void registrarAsistencia();
-    void inscribirseAClase(const std::string& codigoClase);
-    void cancelarClase(const std::string& codigoClase);
-    int getCantidadClasesInscritas() const { return clasesInscritas.size(); }
-    void mostrarInformacion() const;
+public:
+    explicit Benchmark(const ConfigBenchmark& config) : config(config) {}
+    void ejecutar();
+    void mostrarReporte() const;
 };
 
+// Lee "--benchmark [--miembros N] [--clases N] [--ops N] [--capacidad N]
+// [--mezcla B,P,V] [--sesgo S] [--semilla N] [--repeticiones N]"; false si algun
+// argumento es invalido
+bool parsearConfigBenchmark(int argc, char* argv[], ConfigBenchmark& config);
+
 // =================================================================================
-// ARCHIVO: Gimnasio.h
-// RESPONSABILIDAD: Orquesta todas las operaciones del gimnasio
+// ARCHIVO: Benchmark.cpp
 // =================================================================================
 
-class Gimnasio {
+// Muestrea indices 0..n-1 con probabilidad proporcional a 1/(i+1)^sesgo
+class MuestreadorZipf {
 private:
-    std::string nombre;
-    std::vector<Miembro> miembros;
-    std::vector<ClaseGym> clases;
-    int totalAsistenciasHoy;
-
-    // Métodos auxiliares privados
-    Miembro* buscarMiembroPorId(int idMiembro);
-    ClaseGym* buscarClasePorCodigo(const std::string& codigo);
+    std::vector<double> acumulada;
 
 public:
-    Gimnasio(const std::string& nombre);
+    MuestreadorZipf(std::size_t n, double sesgo) : acumulada(n) {
+        double suma = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            suma += 1.0 / std::pow(static_cast<double>(i + 1), sesgo);
+            acumulada[i] = suma;
+        }
+    }
 
-    // Gestión de miembros
-    void registrarMiembro(const std::string& nombre, int idMiembro, 
-                         const std::string& tipoMembresia);
-    void mostrarMiembros() const;
-    void suspenderMembresia(int idMiembro);
-    void reactivarMembresia(int idMiembro);
+    template <typename Generador>
+    std::size_t operator()(Generador& rng) {
+        std::uniform_real_distribution<double> uniforme(0.0, acumulada.back());
+        auto it = std::lower_bound(acumulada.begin(), acumulada.end(), uniforme(rng));
+        return std::min<std::size_t>(it - acumulada.begin(), acumulada.size() - 1);
+    }
+};
 
-    // Gestión de clases
-    void crearClase(const std::string& nombre, const std::string& instructor,
-                   const std::string& horario, const std::string& codigo, 
-                   int capacidad);
-    void mostrarHorarioClases() const;
+void Benchmark::agregarResultado(const std::string& operacion,
+                                 std::vector<std::uint64_t>& latencias, double segundos) {
+    auto percentil = [&](double p) -> double {
+        if (latencias.empty()) return 0;
+        std::size_t k = static_cast<std::size_t>(p * (latencias.size() - 1));
+        std::nth_element(latencias.begin(), latencias.begin() + k, latencias.end());
+        return static_cast<double>(latencias[k]);
+    };
+    double p50 = percentil(0.50);
+    double p99 = percentil(0.99);
+    resultados.push_back({operacion, latencias.size(), segundos, p50, p99});
+}
 
-    // Operaciones principales
-    void registrarAsistencia(int idMiembro);
-    void inscribirMiembroAClase(int idMiembro, const std::string& codigoClase);
-    void cancelarInscripcionClase(int idMiembro, const std::string& codigoClase);
+void Benchmark::ejecutar() {
+    using Reloj = std::chrono::steady_clock;
+    auto nanos = [](Reloj::time_point a, Reloj::time_point b) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+    };
+    auto segundos = [](Reloj::time_point a, Reloj::time_point b) {
+        return std::chrono::duration<double>(b - a).count();
+    };
 
-    // Reportes
-    void mostrarResumenDiario() const;
+    std::mt19937_64 rng(config.semilla);
+    std::discrete_distribution<int> mezcla(std::begin(config.mezclaMembresias),
+                                           std::end(config.mezclaMembresias));
+    std::uniform_int_distribution<int> miembroAlAzar(0, config.miembros - 1);
+    MuestreadorZipf claseAlAzar(config.clases, config.sesgoInscripcion);
 
-    // Persistencia de datos
-    void guardarDatos(const std::string& archivo);
-    void cargarDatos(const std::string& archivo);
-};
+    std::vector<std::string> codigos;
+    codigos.reserve(config.clases);
+    for (int c = 0; c < config.clases; c++) codigos.push_back("C" + std::to_string(c));
 
-// =================================================================================
-// ARCHIVO: ClaseGym.cpp
-// =================================================================================
+    Gimnasio gym("Benchmark");
+    std::vector<std::uint64_t> latencias;
 
-ClaseGym::ClaseGym(const std::string& nombre, const std::string& instructor,
-                   const std::string& horario, const std::string& codigo, int capacidad)
-    : nombreClase(nombre), instructor(instructor), horario(horario),
-      codigoClase(codigo), capacidadMaxima(capacidad), inscritos(0) {}
+    // Alta masiva de miembros
+    latencias.reserve(config.miembros);
+    auto inicio = Reloj::now();
+    for (int i = 0; i < config.miembros; i++) {
+        TipoMembresia tipo = static_cast<TipoMembresia>(mezcla(rng));
+        auto t0 = Reloj::now();
+        gym.ejecutarRegistroMiembro("Miembro " + std::to_string(i), i, tipo);
+        latencias.push_back(nanos(t0, Reloj::now()));
+    }
+    agregarResultado("registrarMiembro", latencias, segundos(inicio, Reloj::now()));
 
-bool ClaseGym::inscribirMiembro(int idMiembro) {
-    if (!tieneCupo()) {
-        return false;
+    // Horarios repartidos en la semana (7 dias x 16 franjas de una hora desde las 06:00)
+    const char* const dias[] = {"Lun", "Mar", "Mie", "Jue", "Vie", "Sab", "Dom"};
+    for (int c = 0; c < config.clases; c++) {
+        int hora = 6 + (c / 7) % 16;
+        char horario[32];
+        std::snprintf(horario, sizeof(horario), "%s %02d:00-%02d:00", dias[c % 7], hora, hora + 1);
+        gym.ejecutarCreacionClase("Clase " + std::to_string(c), "Instructor",
+                                  horario, codigos[c], config.capacidadClase);
     }
-    
-    auto it = std::find(idsMiembrosInscritos.begin(), 
-                       idsMiembrosInscritos.end(), idMiembro);
-    if (it != idsMiembrosInscritos.end()) {
-        return false;
+
+    // Asistencias
+    latencias.clear();
+    inicio = Reloj::now();
+    for (int k = 0; k < config.operaciones; k++) {
+        int id = miembroAlAzar(rng);
+        auto t0 = Reloj::now();
+        gym.ejecutarAsistencia(id);
+        latencias.push_back(nanos(t0, Reloj::now()));
     }
-    
-    idsMiembrosInscritos.push_back(idMiembro);
-    inscritos++;
-    return true;
-}
+    agregarResultado("registrarAsistencia", latencias, segundos(inicio, Reloj::now()));
 
-bool ClaseGym::cancelarInscripcion(int idMiembro) {
-    auto it = std::find(idsMiembrosInscritos.begin(), 
-                       idsMiembrosInscritos.end(), idMiembro);
-    if (it != idsMiembrosInscritos.end()) {
-        idsMiembrosInscritos.erase(it);
-        inscritos--;
-        return true;
+    // Inscripciones con sesgo hacia las clases populares
+    std::vector<std::pair<int, std::size_t>> inscritos;
+    inscritos.reserve(config.operaciones);
+    latencias.clear();
+    inicio = Reloj::now();
+    for (int k = 0; k < config.operaciones; k++) {
+        int id = miembroAlAzar(rng);
+        std::size_t clase = claseAlAzar(rng);
+        auto t0 = Reloj::now();
+        CodigoResultado r = gym.ejecutarInscripcion(id, codigos[clase]);
+        latencias.push_back(nanos(t0, Reloj::now()));
+        if (r == CodigoResultado::Ok) inscritos.emplace_back(id, clase);
     }
-    return false;
+    agregarResultado("inscribirMiembroAClase", latencias, segundos(inicio, Reloj::now()));
+
+    // Persistencia con la poblacion ya inscrita. Se mide solo el trabajo propio:
+    // armar cada imagen (captura incluida) y cargarla de un archivo ya en cache;
+    // la escritura a disco y los mensajes quedan fuera. Los archivos van a un
+    // directorio temporal para no tocar los datos reales.
+    char plantilla[] = "/tmp/gimnasio_benchmarkXXXXXX";
+    const char* dir = ::mkdtemp(plantilla);
+    if (dir == nullptr) {
+        std::cout << "ERROR: No se pudo crear un directorio temporal; se omite la persistencia.\n";
+    } else {
+        const std::string archivoTexto = std::string(dir) + "/datos.txt";
+        const std::string archivoSnapshot = std::string(dir) + "/datos.snap";
+        std::string imagenTexto, imagenSnapshot;
+        struct Persistencia {
+            const char* nombre;
+            std::function<void()> accion;
+            std::function<void()> alTerminar;  // una vez, fuera de la medicion
+        };
+        Gimnasio destino("Benchmark (carga)");
+        Persistencia pasos[] = {
+            {"imagenDatos", [&] { imagenTexto = gym.imagenDatos(); },
+             [&] { escribirArchivoAtomico(archivoTexto, imagenTexto.data(), imagenTexto.size()); }},
+            {"cargarDatos", [&] { destino.cargarDatos(archivoTexto, false); }, nullptr},
+            {"imagenSnapshot", [&] { imagenSnapshot = gym.imagenSnapshot(); },
+             [&] {
+                 escribirArchivoAtomico(archivoSnapshot, imagenSnapshot.data(),
+                                        imagenSnapshot.size());
+             }},
+            {"cargarSnapshot", [&] { destino.cargarSnapshot(archivoSnapshot, false); }, nullptr},
+        };
+        for (auto& paso : pasos) {
+            latencias.clear();
+            inicio = Reloj::now();
+            for (int r = 0; r < config.repeticionesPersistencia; r++) {
+                auto t0 = Reloj::now();
+                paso.accion();
+                latencias.push_back(nanos(t0, Reloj::now()));
+            }
+            agregarResultado(paso.nombre, latencias, segundos(inicio, Reloj::now()));
+            if (paso.alTerminar) paso.alTerminar();
+        }
+        ::unlink(archivoTexto.c_str());
+        ::unlink(archivoSnapshot.c_str());
+        ::rmdir(dir);
+    }
+
+    // Cancelaciones de inscripciones existentes, en orden aleatorio
+    std::shuffle(inscritos.begin(), inscritos.end(), rng);
+    latencias.clear();
+    inicio = Reloj::now();
+    for (const auto& inscripcion : inscritos) {
+        auto t0 = Reloj::now();
+        gym.ejecutarCancelacion(inscripcion.first, codigos[inscripcion.second]);
+        latencias.push_back(nanos(t0, Reloj::now()));
+    }
+    agregarResultado("cancelarInscripcionClase", latencias, segundos(inicio, Reloj::now()));
 }
 
-bool ClaseGym::estaMiembroInscrito(int idMiembro) const {
-    return std::find(idsMiembrosInscritos.begin(), 
-                    idsMiembrosInscritos.end(), 
-                    idMiembro) != idsMiembrosInscritos.end();
+void Benchmark::mostrarReporte() const {
+    std::cout << "\n================ BENCHMARK ================\n"
+              << "Miembros: " << config.miembros << " | Clases: " << config.clases
+              << " | Operaciones: " << config.operaciones
+              << " | Sesgo: " << config.sesgoInscripcion
+              << " | Mezcla B/P/V: " << config.mezclaMembresias[0] << "/"
+              << config.mezclaMembresias[1] << "/" << config.mezclaMembresias[2] << "\n\n";
+    std::cout << std::left << std::setw(26) << "Operacion" << std::right
+              << std::setw(10) << "Muestras" << std::setw(14) << "Ops/seg"
+              << std::setw(14) << "p50 (us)" << std::setw(14) << "p99 (us)" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& r : resultados) {
+        double porSegundo = r.segundos > 0 ? r.muestras / r.segundos : 0;
+        std::cout << std::left << std::setw(26) << r.operacion << std::right
+                  << std::setw(10) << r.muestras << std::setw(14) << porSegundo
+                  << std::setw(14) << r.p50Ns / 1000.0 << std::setw(14) << r.p99Ns / 1000.0
+                  << "\n";
+    }
+    std::cout << "===========================================\n";
 }
 
-void ClaseGym::mostrarInformacion() const {
-    std::cout << " - Codigo: " << codigoClase << "\n"
-              << "   Clase: " << nombreClase << "\n"
-              << "   Instructor: " << instructor << "\n"
-              << "   Horario: " << horario << "\n"
-              << "   Cupos: " << inscritos << "/" << capacidadMaxima
-              << " (" << (tieneCupo() ? "Disponible" : "LLENO") << ")\n";
+bool parsearConfigBenchmark(int argc, char* argv[], ConfigBenchmark& config) {
+    for (int i = 2; i < argc; i++) {
+        std::string opcion = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string valor = argv[++i];
+        try {
+            if (opcion == "--miembros") config.miembros = std::stoi(valor);
+            else if (opcion == "--clases") config.clases = std::stoi(valor);
+            else if (opcion == "--ops") config.operaciones = std::stoi(valor);
+            else if (opcion == "--capacidad") config.capacidadClase = std::stoi(valor);
+            else if (opcion == "--sesgo") config.sesgoInscripcion = std::stod(valor);
+            else if (opcion == "--semilla") config.semilla = static_cast<unsigned>(std::stoul(valor));
+            else if (opcion == "--repeticiones") config.repeticionesPersistencia = std::stoi(valor);
+            else if (opcion == "--mezcla") {
+                std::stringstream ss(valor);
+                char coma;
+                ss >> config.mezclaMembresias[0] >> coma >> config.mezclaMembresias[1]
+                   >> coma >> config.mezclaMembresias[2];
+                if (!ss) return false;
+            } else {
+                return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return config.miembros > 0 && config.clases > 0 && config.operaciones >= 0 &&
+           config.repeticionesPersistencia > 0;
 }
 
 // =================================================================================
-// ARCHIVO: Miembro.cpp
+// ARCHIVO: ModoLote.h
+// RESPONSABILIDAD: Aplica un archivo de comandos sin menu ni salida por operacion
 // =================================================================================
 
-Miembro::Miembro(const std::string& nombre, int idMiembro, const std::string& tipoMembresia)
-    : nombre(nombre), idMiembro(idMiembro), tipoMembresia(tipoMembresia),
-      membresiaActiva(true), diasAsistencia(0) {}
+// Formato: un comando por linea, campos separados por espacios.
+//   M <id> <membresia> <nombre...>                registrar miembro
+//   C <codigo> <capacidad> <nombre>|<instructor>|<horario>   crear clase
+//   A <id> [<id>...]                              asistencia (torniquete)
+//   I <id> <codigo>                               inscribir a clase
+//   X <id> <codigo>                               cancelar inscripcion
+//   S <id> / R <id>                               suspender / reactivar
+//   G                                             checkpoint (snapshot)
+// Lineas vacias y las que empiezan con '#' se ignoran. Las asistencias
+// consecutivas se acumulan y se aplican como un solo lote.
+class ProcesadorComandos {
+private:
+    static constexpr std::size_t MAX_ERRORES_REPORTADOS = 10;
 
-void Miembro::registrarAsistencia() {
-    diasAsistencia++;
+    Gimnasio& gimnasio;
+    std::string archivoSnapshot;
+    std::vector<int> asistenciasPendientes;
+    std::vector<CodigoResultado> resultadosLote;
+    std::size_t lineas;
+    std::size_t comandos;
+    std::size_t malformadas;
+    std::vector<std::size_t> lineasMalformadas;
+    std::array<std::size_t, NUM_CODIGOS_RESULTADO> conteoResultados;
+    std::string codigo;  // buffer reutilizado para no asignar por linea
+
+    void contar(CodigoResultado resultado);
+    void vaciarAsistencias();
+    bool procesarLinea(const char* inicio, const char* fin);
+
+public:
+    ProcesadorComandos(Gimnasio& gimnasio, const std::string& archivoSnapshot);
+    void procesar(const char* datos, std::size_t largo);
+    void mostrarResumen(double segundos) const;
+};
+
+// =================================================================================
+// ARCHIVO: ModoLote.cpp
+// =================================================================================
+
+namespace {
+
+// Avanza sobre espacios y devuelve el siguiente campo [inicio, fin)
+bool siguienteCampo(const char*& p, const char* fin, const char*& campo, const char*& finCampo) {
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    if (p == fin) return false;
+    campo = p;
+    while (p < fin && *p != ' ' && *p != '\t') p++;
+    finCampo = p;
+    return true;
 }
 
-void Miembro::inscribirseAClase(const std::string& codigoClase) {
-    clasesInscritas.push_back(codigoClase);
+// Si el campo no es un entero no se consume: queda como resto de la linea
+bool siguienteEntero(const char*& p, const char* fin, int& valor) {
+    const char* campo;
+    const char* finCampo;
+    const char* q = p;
+    if (!siguienteCampo(q, fin, campo, finCampo)) return false;
+    auto r = std::from_chars(campo, finCampo, valor);
+    if (r.ec != std::errc() || r.ptr != finCampo) return false;
+    p = q;
+    return true;
 }
 
-void Miembro::cancelarClase(const std::string& codigoClase) {
-    auto it = std::find(clasesInscritas.begin(), clasesInscritas.end(), codigoClase);
-    if (it != clasesInscritas.end()) {
-        clasesInscritas.erase(it);
+// true si no queda nada mas que espacios en [p, fin)
+bool soloEspacios(const char* p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    return p == fin;
+}
+
+// Resto de la linea sin espacios iniciales ni finales
+std::string restoDeLinea(const char* p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    while (fin > p && (fin[-1] == ' ' || fin[-1] == '\t' || fin[-1] == '\r')) fin--;
+    return std::string(p, fin);
+}
+
+}  // namespace
+
+ProcesadorComandos::ProcesadorComandos(Gimnasio& gimnasio, const std::string& archivoSnapshot)
+    : gimnasio(gimnasio), archivoSnapshot(archivoSnapshot), lineas(0), comandos(0),
+      malformadas(0), conteoResultados{} {}
+
+void ProcesadorComandos::contar(CodigoResultado resultado) {
+    conteoResultados[static_cast<std::size_t>(resultado)]++;
+}
+
+void ProcesadorComandos::vaciarAsistencias() {
+    if (asistenciasPendientes.empty()) return;
+    resultadosLote.resize(asistenciasPendientes.size());
+    gimnasio.ejecutarAsistenciasLote(asistenciasPendientes.data(),
+                                     asistenciasPendientes.size(), resultadosLote.data());
+    for (CodigoResultado r : resultadosLote) contar(r);
+    asistenciasPendientes.clear();
+}
+
+bool ProcesadorComandos::procesarLinea(const char* p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    while (fin > p && fin[-1] == '\r') fin--;
+    if (p == fin || *p == '#') return true;
+
+    // Cada comando valida la linea completa antes de tocar el gimnasio: una
+    // linea con campos de mas se rechaza entera, no se aplica a medias.
+    char comando = *p++;
+    if (p < fin && *p != ' ' && *p != '\t') return false;
+    if (comando != 'A') vaciarAsistencias();
+    comandos++;
+
+    int id = 0;
+    const char* campo;
+    const char* finCampo;
+    switch (comando) {
+        case 'A': {
+            const std::size_t antes = asistenciasPendientes.size();
+            while (siguienteEntero(p, fin, id)) asistenciasPendientes.push_back(id);
+            if (asistenciasPendientes.size() == antes || !soloEspacios(p, fin)) {
+                asistenciasPendientes.resize(antes);
+                return false;
+            }
+            return true;
+        }
+        case 'M': {
+            TipoMembresia tipo;
+            if (!siguienteEntero(p, fin, id) || !siguienteCampo(p, fin, campo, finCampo)) {
+                return false;
+            }
+            codigo.assign(campo, finCampo);
+            if (!parsearTipoMembresia(codigo, tipo)) {
+                contar(CodigoResultado::MembresiaInvalida);
+                return true;
+            }
+            std::string nombreMiembro = restoDeLinea(p, fin);
+            if (nombreMiembro.empty()) return false;
+            contar(gimnasio.ejecutarRegistroMiembro(nombreMiembro, id, tipo));
+            return true;
+        }
+        case 'C': {
+            int capacidad = 0;
+            if (!siguienteCampo(p, fin, campo, finCampo)) return false;
+            codigo.assign(campo, finCampo);
+            if (!siguienteEntero(p, fin, capacidad)) return false;
+            std::string resto = restoDeLinea(p, fin);
+            std::size_t sep1 = resto.find('|');
+            std::size_t sep2 = sep1 == std::string::npos ? sep1 : resto.find('|', sep1 + 1);
+            if (sep2 == std::string::npos) return false;
+            contar(gimnasio.ejecutarCreacionClase(resto.substr(0, sep1),
+                                                  resto.substr(sep1 + 1, sep2 - sep1 - 1),
+                                                  resto.substr(sep2 + 1), codigo, capacidad));
+            return true;
+        }
+        case 'I':
+        case 'X': {
+            if (!siguienteEntero(p, fin, id) || !siguienteCampo(p, fin, campo, finCampo) ||
+                !soloEspacios(p, fin)) {
+                return false;
+            }
+            codigo.assign(campo, finCampo);
+            contar(comando == 'I' ? gimnasio.ejecutarInscripcion(id, codigo)
+                                  : gimnasio.ejecutarCancelacion(id, codigo));
+            return true;
+        }
+        case 'S':
+        case 'R': {
+            if (!siguienteEntero(p, fin, id) || !soloEspacios(p, fin)) return false;
+            contar(gimnasio.ejecutarCambioEstado(id, comando == 'R'));
+            return true;
+        }
+        case 'G':
+            if (!soloEspacios(p, fin)) return false;
+            gimnasio.checkpoint(archivoSnapshot);
+            return true;
+        default:
+            return false;
     }
 }
 
-void Miembro::mostrarInformacion() const {
-    std::cout << " - ID: " << idMiembro << "\n"
-              << "   Nombre: " << nombre << "\n"
-              << "   Membresia: " << tipoMembresia << "\n"
-              << "   Estado: " << (membresiaActiva ? "ACTIVA" : "INACTIVA") << "\n"
-              << "   Asistencias: " << diasAsistencia << " dias\n"
-              << "   Clases inscritas: " << clasesInscritas.size() << "\n";
+void ProcesadorComandos::procesar(const char* datos, std::size_t largo) {
+    const char* p = datos;
+    const char* fin = datos + largo;
+    while (p < fin) {
+        const char* finLinea = static_cast<const char*>(std::memchr(p, '\n', fin - p));
+        if (finLinea == nullptr) finLinea = fin;
+        lineas++;
+        std::size_t comandosAntes = comandos;
+        if (!procesarLinea(p, finLinea)) {
+            comandos = comandosAntes;
+            malformadas++;
+            if (lineasMalformadas.size() < MAX_ERRORES_REPORTADOS) {
+                lineasMalformadas.push_back(lineas);
+            }
+        }
+        p = finLinea + 1;
+    }
+    vaciarAsistencias();
+    gimnasio.confirmarCambios();
+}
+
+void ProcesadorComandos::mostrarResumen(double segundos) const {
+    std::cout << "\n=========== RESUMEN DEL LOTE ===========\n"
+              << "Lineas leidas: " << lineas << "\n"
+              << "Comandos aplicados: " << comandos << "\n"
+              << "Lineas malformadas: " << malformadas;
+    if (!lineasMalformadas.empty()) {
+        std::cout << " (lineas:";
+        for (std::size_t n : lineasMalformadas) std::cout << " " << n;
+        if (malformadas > lineasMalformadas.size()) std::cout << " ...";
+        std::cout << ")";
+    }
+    std::cout << "\nResultados:\n";
+    for (std::size_t i = 0; i < NUM_CODIGOS_RESULTADO; i++) {
+        if (conteoResultados[i] > 0) {
+            std::cout << "  " << nombreResultado(static_cast<CodigoResultado>(i)) << ": "
+                      << conteoResultados[i] << "\n";
+        }
+    }
+    std::cout << "Tiempo: " << std::fixed << std::setprecision(3) << segundos << " s\n"
+              << "========================================\n";
 }
 
 // =================================================================================
-// ARCHIVO: Gimnasio.cpp
+// ARCHIVO: Servidor.h
+// RESPONSABILIDAD: Servicio local por socket (epoll) y cliente generador de carga
 // =================================================================================
 
-Gimnasio::Gimnasio(const std::string& nombre) 
-    : nombre(nombre), totalAsistenciasHoy(0) {
-    std::cout << "\n********************************************\n"
-              << "*  Bienvenido a " << nombre << "  *\n"
-              << "********************************************\n" << std::endl;
+// Protocolo de texto: una peticion por linea y una respuesta por linea, en el
+// mismo orden. Un cliente puede mandar muchas peticiones sin esperar (pipeline).
+//   A <id>             asistencia           -> nombre del CodigoResultado ("Ok", ...)
+//   I <id> <codigo>    inscribir a clase    -> idem
+//   X <id> <codigo>    cancelar inscripcion -> idem
+//   S <id> / R <id>    suspender / reactivar -> idem
+//   Q                  resumen              -> "Ok miembros=N clases=N hoy=N cupos=O/T"
+// Una linea que no se entiende responde "Malformada".
+// El destino es un puerto (TCP en 127.0.0.1) o la ruta de un socket Unix.
+
+class ServidorGimnasio {
+public:
+    static constexpr std::size_t MAX_LINEA = 4096;
+    static constexpr std::size_t MAX_SALIDA_PENDIENTE = 4 << 20;  // deja de leer al pasarlo
+
+private:
+    struct Conexion {
+        std::string entrada;   // bytes recibidos aun sin linea completa
+        std::string salida;    // respuestas aun no enviadas
+        std::size_t enviado = 0;
+        bool esperandoEscritura = false;
+    };
+
+    Gimnasio& gimnasio;
+    std::string destino;
+    int fdEscucha;
+    int fdEpoll;
+    int fdSenales;
+    std::unordered_map<int, Conexion> conexiones;
+    std::vector<int> asistenciasPendientes;  // A consecutivas de un mismo despertar
+    std::vector<CodigoResultado> resultadosLote;
+    std::vector<char> bufferLectura;
+    std::string codigo;
+    std::uint64_t peticiones;
+    std::uint64_t despertares;
+    std::uint64_t conexionesAceptadas;
+
+    void aceptar();
+    void atender(int fd, std::uint32_t eventos);
+    void procesar(Conexion& conexion);
+    void procesarLinea(Conexion& conexion, const char* p, const char* fin);
+    void vaciarAsistencias(Conexion& conexion);
+    bool enviar(int fd, Conexion& conexion);  // false si la conexion se cayo
+    void vigilar(int fd, Conexion& conexion);
+    void cerrar(int fd);
+
+public:
+    ServidorGimnasio(Gimnasio& gimnasio, const std::string& destino);
+    ~ServidorGimnasio();
+    ServidorGimnasio(const ServidorGimnasio&) = delete;
+    ServidorGimnasio& operator=(const ServidorGimnasio&) = delete;
+
+    // Bloquea SIGINT/SIGTERM en este hilo (llamar antes de crear otros hilos, que
+    // heredan la mascara) y abre el socket; false si no se pudo escuchar
+    bool iniciar();
+    // Atiende hasta recibir SIGINT o SIGTERM
+    void ejecutar();
+    void mostrarResumen() const;
+};
+
+struct ConfigClienteCarga {
+    std::string destino;
+    int conexiones = 4;
+    int peticiones = 100000;  // por conexion
+    int profundidad = 64;     // peticiones en vuelo por conexion
+    int miembros = 1000;      // IDs al azar en [0, miembros)
+    std::string clase;        // con clase: mezcla inscripciones y cancelaciones
+    unsigned semilla = 42;
+};
+
+// Lee "--cliente-carga <destino> [--conexiones N] [--peticiones N]
+// [--profundidad N] [--miembros N] [--clase C] [--semilla N]"
+bool parsearConfigClienteCarga(int argc, char* argv[], ConfigClienteCarga& config);
+// Mide peticiones por segundo contra un servidor en marcha; 0 si todo respondio
+int ejecutarClienteCarga(const ConfigClienteCarga& config);
+
+// =================================================================================
+// ARCHIVO: Servidor.cpp
+// =================================================================================
+
+namespace {
+
+bool esPuerto(const std::string& destino) {
+    return !destino.empty() && destino.size() <= 5 &&
+           std::all_of(destino.begin(), destino.end(),
+                       [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
 }
 
-Miembro* Gimnasio::buscarMiembroPorId(int idMiembro) {
-    for (auto& miembro : miembros) {
-        if (miembro.getIdMiembro() == idMiembro) {
-            return &miembro;
+// Socket de escucha (bind + listen) o conectado al destino; -1 si falla
+int abrirSocket(const std::string& destino, bool escuchar) {
+    int fd = -1;
+    if (esPuerto(destino)) {
+        sockaddr_in direccion{};
+        direccion.sin_family = AF_INET;
+        direccion.sin_port = htons(static_cast<std::uint16_t>(std::stoi(destino)));
+        direccion.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        int uno = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &uno, sizeof(uno));
+        if (escuchar) ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &uno, sizeof(uno));
+        const sockaddr* d = reinterpret_cast<const sockaddr*>(&direccion);
+        if ((escuchar ? ::bind(fd, d, sizeof(direccion)) : ::connect(fd, d, sizeof(direccion))) != 0) {
+            ::close(fd);
+            return -1;
+        }
+    } else {
+        sockaddr_un direccion{};
+        if (destino.size() >= sizeof(direccion.sun_path)) return -1;
+        direccion.sun_family = AF_UNIX;
+        std::memcpy(direccion.sun_path, destino.c_str(), destino.size() + 1);
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        if (escuchar) ::unlink(destino.c_str());  // socket viejo de una ejecucion anterior
+        const sockaddr* d = reinterpret_cast<const sockaddr*>(&direccion);
+        if ((escuchar ? ::bind(fd, d, sizeof(direccion)) : ::connect(fd, d, sizeof(direccion))) != 0) {
+            ::close(fd);
+            return -1;
         }
     }
-    return nullptr;
+    if (escuchar && ::listen(fd, SOMAXCONN) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
 }
 
-ClaseGym* Gimnasio::buscarClasePorCodigo(const std::string& codigo) {
-    for (auto& clase : clases) {
-        if (clase.getCodigo() == codigo) {
-            return &clase;
-        }
+void agregarRespuesta(std::string& salida, CodigoResultado resultado) {
+    salida += nombreResultado(resultado);
+    salida += '\n';
+}
+
+}  // namespace
+
+ServidorGimnasio::ServidorGimnasio(Gimnasio& gimnasio, const std::string& destino)
+    : gimnasio(gimnasio), destino(destino), fdEscucha(-1), fdEpoll(-1), fdSenales(-1),
+      bufferLectura(64 * 1024), peticiones(0), despertares(0), conexionesAceptadas(0) {}
+
+ServidorGimnasio::~ServidorGimnasio() {
+    for (auto& c : conexiones) ::close(c.first);
+    if (fdEscucha >= 0) {
+        ::close(fdEscucha);
+        if (!esPuerto(destino)) ::unlink(destino.c_str());
     }
-    return nullptr;
+    if (fdSenales >= 0) ::close(fdSenales);
+    if (fdEpoll >= 0) ::close(fdEpoll);
 }
 
-void Gimnasio::registrarMiembro(const std::string& nombre, int idMiembro, 
-                                const std::string& tipoMembresia) {
-    if (buscarMiembroPorId(idMiembro) != nullptr) {
-        std::cout << "ERROR: Ya existe un miembro con ID " << idMiembro << "\n";
-        return;
+bool ServidorGimnasio::iniciar() {
+    sigset_t senales;
+    sigemptyset(&senales);
+    sigaddset(&senales, SIGINT);
+    sigaddset(&senales, SIGTERM);
+    ::pthread_sigmask(SIG_BLOCK, &senales, nullptr);
+    fdSenales = ::signalfd(-1, &senales, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    fdEscucha = abrirSocket(destino, true);
+    fdEpoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (fdEscucha < 0 || fdEpoll < 0 || fdSenales < 0) return false;
+    ::fcntl(fdEscucha, F_SETFL, ::fcntl(fdEscucha, F_GETFL) | O_NONBLOCK);
+
+    epoll_event evento{};
+    evento.events = EPOLLIN;
+    evento.data.fd = fdEscucha;
+    ::epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdEscucha, &evento);
+    evento.data.fd = fdSenales;
+    ::epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdSenales, &evento);
+    return true;
+}
+
+void ServidorGimnasio::ejecutar() {
+    std::cout << "INFO: Escuchando en " << (esPuerto(destino) ? "127.0.0.1:" : "") << destino
+              << " (Ctrl+C para detener)\n";
+    std::array<epoll_event, 128> eventos;
+    bool detener = false;
+    while (!detener) {
+        int n = ::epoll_wait(fdEpoll, eventos.data(), static_cast<int>(eventos.size()), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cout << "ERROR: epoll_wait fallo.\n";
+            break;
+        }
+        despertares++;
+        for (int i = 0; i < n; i++) {
+            int fd = eventos[i].data.fd;
+            if (fd == fdSenales) {
+                detener = true;
+            } else if (fd == fdEscucha) {
+                aceptar();
+            } else {
+                atender(fd, eventos[i].events);
+            }
+        }
+        // Group commit: un solo write (y fsync segun config) por despertar
+        gimnasio.confirmarCambios();
     }
+}
 
-    miembros.emplace_back(nombre, idMiembro, tipoMembresia);
-    std::cout << "INFO: Miembro '" << nombre << "' registrado exitosamente (ID: " 
-              << idMiembro << ")\n";
+void ServidorGimnasio::aceptar() {
+    while (true) {
+        int fd = ::accept4(fdEscucha, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: no quedan pendientes
+        conexionesAceptadas++;
+        conexiones.emplace(fd, Conexion());
+        epoll_event evento{};
+        evento.events = EPOLLIN | EPOLLRDHUP;
+        evento.data.fd = fd;
+        ::epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fd, &evento);
+    }
 }
 
-void Gimnasio::mostrarMiembros() const {
-    std::cout << "\n====== MIEMBROS REGISTRADOS ======\n";
-    if (miembros.empty()) {
-        std::cout << "No hay miembros registrados.\n";
-    } else {
-        std::cout << "Total de miembros: " << miembros.size() << "\n\n";
-        for (const auto& miembro : miembros) {
-            miembro.mostrarInformacion();
-            std::cout << "\n";
+void ServidorGimnasio::atender(int fd, std::uint32_t eventos) {
+    auto it = conexiones.find(fd);
+    if (it == conexiones.end()) return;
+    Conexion& conexion = it->second;
+
+    if (eventos & EPOLLOUT) {
+        if (!enviar(fd, conexion)) return cerrar(fd);
+    }
+    if (eventos & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        // Todo lo que haya llegado en este despertar se procesa de una vez
+        bool cerrada = false;
+        while (conexion.salida.size() - conexion.enviado < MAX_SALIDA_PENDIENTE) {
+            ssize_t leidos = ::read(fd, bufferLectura.data(), bufferLectura.size());
+            if (leidos > 0) {
+                conexion.entrada.append(bufferLectura.data(), static_cast<std::size_t>(leidos));
+                if (static_cast<std::size_t>(leidos) < bufferLectura.size()) break;
+                continue;
+            }
+            if (leidos < 0 && errno == EINTR) continue;
+            if (leidos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            cerrada = true;  // 0 = el cliente cerro; <0 = error
+            break;
         }
+        procesar(conexion);
+        if (conexion.entrada.size() > MAX_LINEA) cerrada = true;  // linea sin fin
+        if (!enviar(fd, conexion) || cerrada) return cerrar(fd);
     }
-    std::cout << "==================================\n";
+    vigilar(fd, conexion);
 }
 
-void Gimnasio::crearClase(const std::string& nombre, const std::string& instructor,
-                         const std::string& horario, const std::string& codigo, 
-                         int capacidad) {
-    if (buscarClasePorCodigo(codigo) != nullptr) {
-        std::cout << "ERROR: Ya existe una clase con codigo " << codigo << "\n";
-        return;
+void ServidorGimnasio::procesar(Conexion& conexion) {
+    const char* inicio = conexion.entrada.data();
+    const char* fin = inicio + conexion.entrada.size();
+    const char* p = inicio;
+    while (true) {
+        const char* finLinea = static_cast<const char*>(std::memchr(p, '\n', fin - p));
+        if (finLinea == nullptr) break;
+        const char* finUtil = finLinea > p && finLinea[-1] == '\r' ? finLinea - 1 : finLinea;
+        procesarLinea(conexion, p, finUtil);
+        p = finLinea + 1;
+    }
+    vaciarAsistencias(conexion);
+    conexion.entrada.erase(0, static_cast<std::size_t>(p - inicio));
+}
+
+void ServidorGimnasio::vaciarAsistencias(Conexion& conexion) {
+    if (asistenciasPendientes.empty()) return;
+    resultadosLote.resize(asistenciasPendientes.size());
+    gimnasio.ejecutarAsistenciasLote(asistenciasPendientes.data(),
+                                     asistenciasPendientes.size(), resultadosLote.data());
+    for (CodigoResultado r : resultadosLote) agregarRespuesta(conexion.salida, r);
+    asistenciasPendientes.clear();
+}
+
+void ServidorGimnasio::procesarLinea(Conexion& conexion, const char* p, const char* fin) {
+    peticiones++;
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    char comando = p < fin ? *p++ : '\0';
+    if (p < fin && *p != ' ' && *p != '\t') comando = '\0';
+
+    int id = 0;
+    if (comando == 'A') {
+        // Las asistencias seguidas se aplican juntas; sus respuestas salen en orden
+        if (siguienteEntero(p, fin, id) && soloEspacios(p, fin)) {
+            asistenciasPendientes.push_back(id);
+            return;
+        }
+        comando = '\0';
     }
+    vaciarAsistencias(conexion);
 
-    clases.emplace_back(nombre, instructor, horario, codigo, capacidad);
-    std::cout << "INFO: Clase '" << nombre << "' creada exitosamente (Codigo: " 
-              << codigo << ")\n";
+    const char* campo;
+    const char* finCampo;
+    switch (comando) {
+        case 'I':
+        case 'X':
+            if (siguienteEntero(p, fin, id) && siguienteCampo(p, fin, campo, finCampo) &&
+                soloEspacios(p, fin)) {
+                codigo.assign(campo, finCampo);
+                agregarRespuesta(conexion.salida, comando == 'I'
+                                                      ? gimnasio.ejecutarInscripcion(id, codigo)
+                                                      : gimnasio.ejecutarCancelacion(id, codigo));
+                return;
+            }
+            break;
+        case 'S':
+        case 'R':
+            if (siguienteEntero(p, fin, id) && soloEspacios(p, fin)) {
+                agregarRespuesta(conexion.salida, gimnasio.ejecutarCambioEstado(id, comando == 'R'));
+                return;
+            }
+            break;
+        case 'Q':
+            if (soloEspacios(p, fin)) {
+                ResumenDiario r = gimnasio.obtenerResumenDiario();
+                conexion.salida += "Ok miembros=" + std::to_string(r.miembros) +
+                                   " clases=" + std::to_string(r.clases) +
+                                   " hoy=" + std::to_string(r.asistenciasHoy) +
+                                   " cupos=" + std::to_string(r.cuposOcupados) + "/" +
+                                   std::to_string(r.cuposTotales) + "\n";
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    conexion.salida += "Malformada\n";
 }
 
-void Gimnasio::mostrarHorarioClases() const {
-    std::cout << "\n======= HORARIO DE CLASES =======\n";
-    if (clases.empty()) {
-        std::cout << "No hay clases programadas.\n";
-    } else {
-        for (const auto& clase : clases) {
-            clase.mostrarInformacion();
-            std::cout << "\n";
+bool ServidorGimnasio::enviar(int fd, Conexion& conexion) {
+    while (conexion.enviado < conexion.salida.size()) {
+        ssize_t n = ::send(fd, conexion.salida.data() + conexion.enviado,
+                           conexion.salida.size() - conexion.enviado, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;  // sigue con EPOLLOUT
+            return false;
         }
+        conexion.enviado += static_cast<std::size_t>(n);
     }
-    std::cout << "=================================\n";
+    conexion.salida.clear();
+    conexion.enviado = 0;
+    return true;
+}
+
+// Con salida pendiente se espera EPOLLOUT; pasado el limite, deja de leer
+void ServidorGimnasio::vigilar(int fd, Conexion& conexion) {
+    const std::size_t pendiente = conexion.salida.size() - conexion.enviado;
+    const bool quiereEscribir = pendiente > 0;
+    const bool quiereLeer = pendiente < MAX_SALIDA_PENDIENTE;
+    if (quiereEscribir == conexion.esperandoEscritura && quiereLeer) return;
+    epoll_event evento{};
+    evento.events = (quiereLeer ? EPOLLIN | EPOLLRDHUP : 0u) | (quiereEscribir ? EPOLLOUT : 0u);
+    evento.data.fd = fd;
+    ::epoll_ctl(fdEpoll, EPOLL_CTL_MOD, fd, &evento);
+    conexion.esperandoEscritura = quiereEscribir;
 }
 
-void Gimnasio::registrarAsistencia(int idMiembro) {
-    Miembro* miembro = buscarMiembroPorId(idMiembro);
+void ServidorGimnasio::cerrar(int fd) {
+    ::epoll_ctl(fdEpoll, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    conexiones.erase(fd);
+}
 
-    if (miembro == nullptr) {
-        std::cout << "ERROR: Miembro con ID " << idMiembro << " no encontrado.\n";
-        return;
-    }
+void ServidorGimnasio::mostrarResumen() const {
+    std::cout << "\n=========== RESUMEN DEL SERVIDOR ===========\n"
+              << "Conexiones atendidas: " << conexionesAceptadas << "\n"
+              << "Peticiones: " << peticiones << "\n"
+              << "Despertares del bucle: " << despertares << " ("
+              << std::fixed << std::setprecision(1)
+              << (despertares > 0 ? double(peticiones) / despertares : 0.0)
+              << " peticiones por despertar)\n"
+              << "============================================\n";
+}
 
-    if (!miembro->estaActivo()) {
-        std::cout << "ERROR: La membresia de " << miembro->getNombre() 
-                  << " esta INACTIVA.\n";
-        return;
+bool parsearConfigClienteCarga(int argc, char* argv[], ConfigClienteCarga& config) {
+    if (argc < 3) return false;
+    config.destino = argv[2];
+    for (int i = 3; i < argc; i++) {
+        std::string opcion = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string valor = argv[++i];
+        try {
+            if (opcion == "--conexiones") config.conexiones = std::stoi(valor);
+            else if (opcion == "--peticiones") config.peticiones = std::stoi(valor);
+            else if (opcion == "--profundidad") config.profundidad = std::stoi(valor);
+            else if (opcion == "--miembros") config.miembros = std::stoi(valor);
+            else if (opcion == "--clase") config.clase = valor;
+            else if (opcion == "--semilla") config.semilla = static_cast<unsigned>(std::stoul(valor));
+            else return false;
+        } catch (const std::exception&) {
+            return false;
+        }
     }
-
-    miembro->registrarAsistencia();
-    totalAsistenciasHoy++;
-    std::cout << "EXITO: Asistencia registrada para " << miembro->getNombre() 
-              << " (Total: " << miembro->getDiasAsistencia() << " dias)\n";
+    return config.conexiones > 0 && config.peticiones > 0 && config.profundidad > 0 &&
+           config.miembros > 0;
 }
 
-void Gimnasio::inscribirMiembroAClase(int idMiembro, const std::string& codigoClase) {
-    Miembro* miembro = buscarMiembroPorId(idMiembro);
-    ClaseGym* clase = buscarClasePorCodigo(codigoClase);
+int ejecutarClienteCarga(const ConfigClienteCarga& config) {
+    struct ResultadoHilo {
+        std::size_t respondidas = 0;
+        std::map<std::string, std::size_t> porRespuesta;
+        std::vector<std::uint64_t> latencias;  // ns por ventana de 'profundidad'
+        bool conectado = true;
+    };
+    std::vector<ResultadoHilo> resultados(config.conexiones);
 
-    if (miembro == nullptr) {
-        std::cout << "ERROR: Miembro con ID " << idMiembro << " no encontrado.\n";
-        return;
-    }
+    auto trabajar = [&config](int indice, ResultadoHilo& resultado) {
+        int fd = abrirSocket(config.destino, false);
+        if (fd < 0) {
+            resultado.conectado = false;
+            return;
+        }
+        std::mt19937 rng(config.semilla + indice);
+        std::uniform_int_distribution<int> miembroAlAzar(0, config.miembros - 1);
+        std::uniform_int_distribution<int> porcentaje(0, 99);
+        std::string envio, recibido;
+        std::vector<char> buffer(64 * 1024);
+        resultado.latencias.reserve(config.peticiones / config.profundidad + 1);
 
-    if (clase == nullptr) {
-        std::cout << "ERROR: Clase con codigo " << codigoClase << " no encontrada.\n";
-        return;
-    }
+        int restantes = config.peticiones;
+        while (restantes > 0) {
+            int ventana = std::min(restantes, config.profundidad);
+            envio.clear();
+            for (int k = 0; k < ventana; k++) {
+                int id = miembroAlAzar(rng);
+                int tirada = porcentaje(rng);
+                if (!config.clase.empty() && tirada < 15) {
+                    envio += "I " + std::to_string(id) + " " + config.clase + "\n";
+                } else if (!config.clase.empty() && tirada < 30) {
+                    envio += "X " + std::to_string(id) + " " + config.clase + "\n";
+                } else if (tirada == 99) {
+                    envio += "Q\n";
+                } else {
+                    envio += "A " + std::to_string(id) + "\n";
+                }
+            }
+            auto t0 = std::chrono::steady_clock::now();
+            std::size_t escrito = 0;
+            while (escrito < envio.size()) {
+                ssize_t n = ::send(fd, envio.data() + escrito, envio.size() - escrito, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                escrito += static_cast<std::size_t>(n);
+            }
+            // Esperar las 'ventana' respuestas y clasificarlas por su primera palabra
+            int faltan = ventana;
+            while (faltan > 0) {
+                ssize_t n = ::read(fd, buffer.data(), buffer.size());
+                if (n <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                recibido.append(buffer.data(), static_cast<std::size_t>(n));
+                std::size_t inicio = 0, salto;
+                while ((salto = recibido.find('\n', inicio)) != std::string::npos) {
+                    std::size_t finPalabra = std::min(recibido.find(' ', inicio), salto);
+                    resultado.porRespuesta[recibido.substr(inicio, finPalabra - inicio)]++;
+                    resultado.respondidas++;
+                    faltan--;
+                    inicio = salto + 1;
+                }
+                recibido.erase(0, inicio);
+            }
+            resultado.latencias.push_back(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - t0).count()));
+            restantes -= ventana;
+        }
+        ::close(fd);
+    };
 
-    if (!miembro->estaActivo()) {
-        std::cout << "ERROR: Membresia inactiva.\n";
-        return;
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<std::thread> hilos;
+    for (int c = 0; c < config.conexiones; c++) {
+        hilos.emplace_back(trabajar, c, std::ref(resultados[c]));
     }
+    for (auto& hilo : hilos) hilo.join();
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
 
-    if (!clase->tieneCupo()) {
-        std::cout << "ERROR: La clase '" << clase->getNombre() << "' esta LLENA.\n";
-        return;
+    std::size_t respondidas = 0, sinConexion = 0;
+    std::map<std::string, std::size_t> porRespuesta;
+    std::vector<std::uint64_t> latencias;
+    for (const auto& r : resultados) {
+        if (!r.conectado) sinConexion++;
+        respondidas += r.respondidas;
+        for (const auto& par : r.porRespuesta) porRespuesta[par.first] += par.second;
+        latencias.insert(latencias.end(), r.latencias.begin(), r.latencias.end());
     }
+    std::sort(latencias.begin(), latencias.end());
+    auto percentil = [&](double p) {
+        return latencias.empty() ? 0.0
+                                 : latencias[static_cast<std::size_t>(p * (latencias.size() - 1))] / 1000.0;
+    };
 
-    if (clase->estaMiembroInscrito(idMiembro)) {
-        std::cout << "ERROR: El miembro ya esta inscrito en esta clase.\n";
-        return;
+    const std::size_t esperadas = std::size_t(config.conexiones) * config.peticiones;
+    std::cout << "\n=========== CLIENTE DE CARGA ===========\n"
+              << "Destino: " << config.destino << " | Conexiones: " << config.conexiones
+              << " | Profundidad: " << config.profundidad << "\n";
+    if (sinConexion > 0) {
+        std::cout << "ERROR: " << sinConexion << " conexion(es) no se pudieron abrir.\n";
     }
-
-    int limiteClases = 0;
-    if (miembro->getTipoMembresia() == "Basica") limiteClases = 2;
-    else if (miembro->getTipoMembresia() == "Premium") limiteClases = 5;
-    else if (miembro->getTipoMembresia() == "VIP") limiteClases = 999;
-
-    if (miembro->getCantidadClasesInscritas() >= limiteClases) {
-        std::cout << "ERROR: Limite de clases alcanzado para membresia "
-                  << miembro->getTipoMembresia() << " (" << limiteClases << " clases).\n";
-        return;
+    std::cout << "Respuestas: " << respondidas << "/" << esperadas << "\n"
+              << std::fixed << std::setprecision(3) << "Tiempo: " << segundos << " s\n"
+              << std::setprecision(0) << "Peticiones/seg: "
+              << (segundos > 0 ? respondidas / segundos : 0.0) << "\n"
+              << std::setprecision(1) << "Ventana (us) p50: " << percentil(0.50)
+              << " | p99: " << percentil(0.99) << "\n"
+              << "Respuestas por tipo:\n";
+    for (const auto& par : porRespuesta) {
+        std::cout << "  " << par.first << ": " << par.second << "\n";
     }
-
-    clase->inscribirMiembro(idMiembro);
-    miembro->inscribirseAClase(codigoClase);
-    
-    std::cout << "EXITO: " << miembro->getNombre() << " inscrito en '" 
-              << clase->getNombre() << "'\n";
+    std::cout << "========================================\n";
+    return respondidas == esperadas ? 0 : 1;
 }
 
-void Gimnasio::cancelarInscripcionClase(int idMiembro, const std::string& codigoClase) {
-    Miembro* miembro = buscarMiembroPorId(idMiembro);
-    ClaseGym* clase = buscarClasePorCodigo(codigoClase);
+// =================================================================================
+// ARCHIVO: Pruebas.h
+// RESPONSABILIDAD: Autoverificacion de las piezas de bajo nivel ("--pruebas")
+// =================================================================================
 
-    if (miembro == nullptr || clase == nullptr) {
-        std::cout << "ERROR: Miembro o clase no encontrado.\n";
-        return;
-    }
+// Corre todas las pruebas, informa cada falla y devuelve 0 si pasaron todas
+int ejecutarPruebas();
 
-    if (!clase->estaMiembroInscrito(idMiembro)) {
-        std::cout << "ERROR: El miembro no esta inscrito en esta clase.\n";
-        return;
-    }
+// =================================================================================
+// ARCHIVO: Pruebas.cpp
+// =================================================================================
 
-    clase->cancelarInscripcion(idMiembro);
-    miembro->cancelarClase(codigoClase);
+namespace {
 
-    std::cout << "EXITO: Inscripcion cancelada exitosamente.\n";
-}
+// Junta las fallas de una prueba sin cortarla, para verlas todas juntas
+struct Verificador {
+    std::vector<std::string> fallas;
 
-void Gimnasio::suspenderMembresia(int idMiembro) {
-    Miembro* miembro = buscarMiembroPorId(idMiembro);
-    if (miembro != nullptr) {
-        miembro->setMembresiaActiva(false);
-        std::cout << "INFO: Membresia de " << miembro->getNombre() << " suspendida.\n";
-    } else {
-        std::cout << "ERROR: Miembro no encontrado.\n";
+    void operator()(bool condicion, const std::string& descripcion) {
+        if (!condicion) fallas.push_back(descripcion);
     }
-}
+};
 
-void Gimnasio::reactivarMembresia(int idMiembro) {
-    Miembro* miembro = buscarMiembroPorId(idMiembro);
-    if (miembro != nullptr) {
-        miembro->setMembresiaActiva(true);
-        std::cout << "INFO: Membresia de " << miembro->getNombre() << " reactivada.\n";
-    } else {
-        std::cout << "ERROR: Miembro no encontrado.\n";
-    }
+// Los avisos de las operaciones (cargas, journal) no ensucian el reporte
+class SilenciarSalida {
+public:
+    SilenciarSalida() { std::cout.setstate(std::ios::failbit); }
+    ~SilenciarSalida() { std::cout.clear(); }
+};
+
+std::string leerArchivo(const std::string& ruta) {
+    ArchivoMapeado mapa(ruta);
+    return mapa.valido() ? std::string(mapa.data(), mapa.size()) : std::string();
 }
 
-void Gimnasio::mostrarResumenDiario() const {
-    std::cout << "\n********** RESUMEN DEL DIA **********\n"
-              << "Gimnasio: " << nombre << "\n"
-              << "Total de miembros: " << miembros.size() << "\n"
-              << "Asistencias registradas hoy: " << totalAsistenciasHoy << "\n"
-              << "Clases programadas: " << clases.size() << "\n";
-    
-    int cuposOcupados = 0, cuposTotales = 0;
-    for (const auto& clase : clases) {
-        cuposOcupados += clase.getInscritos();
-        cuposTotales += clase.getCapacidadMaxima();
+// Miembros y clases tal como los exporta el gimnasio, para comparar estados
+std::string volcarEstado(const Gimnasio& gimnasio, const std::string& ruta) {
+    {
+        SalidaBuffer salida;
+        if (!salida.abrir(ruta)) return std::string();
+        gimnasio.exportarMiembros(salida, FiltroMiembros(), FormatoExportacion::Json);
+        gimnasio.exportarClases(salida, FiltroClases(), FormatoExportacion::Csv);
     }
-    
-    std::cout << "Cupos ocupados: " << cuposOcupados << "/" << cuposTotales << "\n"
-              << "************************************\n";
+    return leerArchivo(ruta);
 }
 
-// =================================================================================
-// PERSISTENCIA DE DATOS
-// =================================================================================
-
-void Gimnasio::guardarDatos(const std::string& archivo) {
-    std::ofstream file(archivo);
-    
-    if (!file.is_open()) {
-        std::cout << "ERROR: No se pudo crear el archivo " << archivo << "\n";
-        return;
+void probarConjuntoIds(Verificador& verificar) {
+    // Muchas colisiones y borrados en orden aleatorio: tras cada borrado todo lo
+    // que sigue en el conjunto se tiene que encontrar (el corrimiento hacia atras
+    // no puede dejar huecos en una cadena de sondeo)
+    std::mt19937 azar(7);
+    ConjuntoIds conjunto;
+    std::vector<std::int32_t> ids;
+    for (std::int32_t id = -500; id < 1500; id += 1 + static_cast<std::int32_t>(azar() % 3)) {
+        ids.push_back(id);
+        verificar(conjunto.insertar(id), "insertar " + std::to_string(id));
     }
-
-    // Guardar miembros
-    file << miembros.size() << "\n";
-    for (const auto& m : miembros) {
-        file << m.getNombre() << "|" 
-             << m.getIdMiembro() << "|"
-             << m.getTipoMembresia() << "|"
-             << m.estaActivo() << "|"
-             << m.getDiasAsistencia() << "\n";
+    verificar(!conjunto.insertar(ids.front()), "un ID repetido no se inserta");
+    std::shuffle(ids.begin(), ids.end(), azar);
+    const std::size_t mitad = ids.size() / 2;
+    for (std::size_t i = 0; i < mitad; i++) {
+        verificar(conjunto.eliminar(ids[i]), "eliminar " + std::to_string(ids[i]));
+        verificar(!conjunto.contiene(ids[i]), "sigue " + std::to_string(ids[i]) + " tras borrarlo");
+        if (i % 50 == 0) {
+            for (std::size_t k = i + 1; k < ids.size(); k++) {
+                verificar(conjunto.contiene(ids[k]), "se perdio " + std::to_string(ids[k]));
+            }
+        }
     }
-
-    // Guardar clases
-    file << clases.size() << "\n";
-    for (const auto& c : clases) {
-        file << c.getNombre() << "|"
-             << c.getInstructor() << "|"
-             << c.getHorario() << "|"
-             << c.getCodigo() << "|"
-             << c.getCapacidadMaxima() << "\n";
+    verificar(!conjunto.eliminar(ids.front()), "eliminar dos veces");
+    verificar(conjunto.size() == ids.size() - mitad, "cantidad tras los borrados");
+    std::size_t recorridos = 0;
+    conjunto.paraCada([&](std::int32_t) { recorridos++; });
+    verificar(recorridos == conjunto.size(), "paraCada recorre la cantidad justa");
+    for (std::size_t i = 0; i < mitad; i++) {
+        verificar(conjunto.insertar(ids[i]), "reinsertar " + std::to_string(ids[i]));
     }
-
-    file.close();
-    std::cout << "\n✅ Datos guardados exitosamente en '" << archivo << "'\n";
+    verificar(conjunto.size() == ids.size(), "cantidad tras reinsertar");
 }
 
-void Gimnasio::cargarDatos(const std::string& archivo) {
-    std::ifstream file(archivo);
-    
-    if (!file.is_open()) {
-        std::cout << "⚠️  No se encontro archivo de datos previos. Iniciando desde cero.\n";
-        return;
+void probarSerieTemporal(Verificador& verificar) {
+    // Deltas en el borde de cada largo de varint (1, 2, 3, 5 y 9 bytes) y
+    // suficientes eventos para ocupar varios bloques
+    const std::int64_t deltas[] = {0, 1, 127, 128, 16383, 16384, 2097152, 1LL << 35, 1LL << 62};
+    std::vector<std::int64_t> esperados;
+    SerieTemporal serie;
+    std::int64_t t = 1700000000;
+    for (std::size_t i = 0; i < 3 * SerieTemporal::EVENTOS_POR_BLOQUE + 5; i++) {
+        t += i < 20 ? deltas[i % 8] : static_cast<std::int64_t>(i % 4) * 86400;
+        serie.agregar(t);
+        esperados.push_back(t);
     }
+    t += deltas[8];
+    serie.agregar(t);
+    esperados.push_back(t);
 
-    miembros.clear();
-    clases.clear();
+    auto leer = [](const SerieTemporal& s) {
+        std::vector<std::int64_t> v;
+        s.paraCadaEntre(std::numeric_limits<std::int64_t>::min(),
+                        std::numeric_limits<std::int64_t>::max(),
+                        [&](std::int64_t momento) { v.push_back(momento); });
+        return v;
+    };
+    verificar(leer(serie) == esperados, "los momentos decodificados no coinciden");
+    verificar(serie.size() == esperados.size(), "size() de la serie");
+    const std::int64_t desde = esperados[100], hasta = esperados[300];
+    std::size_t enRango = static_cast<std::size_t>(std::count_if(
+        esperados.begin(), esperados.end(),
+        [&](std::int64_t m) { return m >= desde && m < hasta; }));
+    verificar(serie.contarEntre(desde, hasta) == enRango, "contarEntre sobre varios bloques");
 
-    // Cargar miembros
-    int numMiembros;
-    file >> numMiembros;
-    file.ignore();
+    std::string bytes;
+    serie.serializar(bytes);
+    SerieTemporal copia;
+    verificar(copia.deserializar(bytes.data(), bytes.size()), "deserializar lo serializado");
+    verificar(leer(copia) == esperados, "la copia deserializada difiere");
 
-    for (int i = 0; i < numMiembros; i++) {
-        std::string linea;
-        std::getline(file, linea);
-        std::stringstream ss(linea);
-        
-        std::string nombre, tipo;
-        int id, asistencias;
-        bool activo;
-        char delimiter;
+    // Un varint que se corta en el ultimo byte de los datos se rechaza
+    std::string cortado = bytes;
+    cortado.back() = static_cast<char>(cortado.back() | 0x80);
+    SerieTemporal rechazada;
+    verificar(!rechazada.deserializar(cortado.data(), cortado.size()),
+              "varint sin terminar aceptado");
+    verificar(rechazada.size() == 0, "una serie rechazada queda vacia");
+    verificar(!rechazada.deserializar(bytes.data(), bytes.size() - 1), "largo incorrecto aceptado");
+}
 
-        std::getline(ss, nombre, '|');
-        ss >> id >> delimiter;
-        std::getline(ss, tipo, '|');
-        ss >> activo >> delimiter >> asistencias;
+void probarParsearHorario(Verificador& verificar) {
+    auto intervalos = [](const std::string& texto, bool& valido) {
+        std::vector<IntervaloSemanal> v;
+        valido = parsearHorario(texto, v);
+        std::vector<std::pair<int, int>> pares;
+        for (const IntervaloSemanal& i : v) pares.emplace_back(i.inicio, i.fin);
+        return pares;
+    };
+    using Pares = std::vector<std::pair<int, int>>;
+    const int h = 60;
+    bool valido;
 
-        Miembro m(nombre, id, tipo);
-        m.setMembresiaActiva(activo);
-        for (int j = 0; j < asistencias; j++) {
-            m.registrarAsistencia();
+    verificar(intervalos("Lun 08:00-10:00; Lun 09:00-11:00", valido) == Pares{{8 * h, 11 * h}} &&
+                  valido,
+              "solapados en el mismo dia se fusionan");
+    verificar(intervalos("Lun 08:00-09:00; Lun 09:00-10:00", valido) == Pares{{8 * h, 10 * h}},
+              "contiguos se fusionan");
+    verificar(intervalos("Lun 08:00-09:00; Lun 07:00-12:00", valido) == Pares{{7 * h, 12 * h}},
+              "uno contenido en otro");
+    verificar(intervalos("Mie 18:00-19:00; Lun 18:00-19:00", valido) ==
+                  Pares{{18 * h, 19 * h}, {2 * MINUTOS_DIA + 18 * h, 2 * MINUTOS_DIA + 19 * h}},
+              "quedan ordenados por inicio");
+    verificar(intervalos("Dom 23:00-01:00", valido) ==
+                  Pares{{0, h}, {6 * MINUTOS_DIA + 23 * h, MINUTOS_SEMANA}},
+              "cruce de domingo a lunes");
+    verificar(intervalos("Dom 23:00-01:00; Lun 00:30-02:00", valido) ==
+                  Pares{{0, 2 * h}, {6 * MINUTOS_DIA + 23 * h, MINUTOS_SEMANA}},
+              "cruce de semana fusionado con el lunes");
+    intervalos("Xyz 10:00-11:00", valido);
+    verificar(!valido, "dia desconocido aceptado");
+    intervalos("Lun 10:00", valido);
+    verificar(!valido, "tramo sin fin aceptado");
+}
+
+void probarTrozosTexto(Verificador& verificar) {
+    // Dos lineas invalidas (3 y 9); cualquier corte tiene que dar la misma
+    // numeracion y los mismos registros que leer todo en un trozo
+    const std::string archivo =
+        "3\n"
+        "Ana|1|VIP|1|0\n"
+        "Bo|2|Oro|1|0\n"
+        "Cy|3|Basica|0|2|1700000000;86400\n"
+        "1\n"
+        "Yoga|Pat|Lun 08:00-09:00|C1|10\n"
+        "2\n"
+        "C1|1,3\n"
+        "C1|x\n";
+    const std::vector<std::size_t> esperadas = {3, 9};
+    for (std::size_t trozos = 1; trozos <= archivo.size(); trozos++) {
+        TextoGimnasio texto;
+        const std::string caso = " (" + std::to_string(trozos) + " trozos)";
+        if (!analizarTextoGimnasio(archivo.data(), archivo.size(), texto, trozos)) {
+            verificar(false, "cabeceras ilegibles" + caso);
+            continue;
+        }
+        std::vector<std::size_t> malformadas;
+        std::size_t miembros = 0, clases = 0, ids = 0, momentos = 0;
+        for (const TrozoTexto& trozo : texto.trozos) {
+            for (const LineaMalformada& m : trozo.malformadas) malformadas.push_back(m.linea);
+            miembros += trozo.miembros.size();
+            clases += trozo.clases.size();
+            ids += trozo.idsInscritos.size();
+            for (const MiembroTexto& m : trozo.miembros) {
+                momentos += m.numMomentos;
+                if (m.id == 3) verificar(m.linea == 4, "linea del miembro 3" + caso);
+            }
         }
-        miembros.push_back(m);
+        verificar(malformadas == esperadas, "numeracion de lineas malformadas" + caso);
+        verificar(miembros == 2 && clases == 1 && ids == 2 && momentos == 2,
+                  "registros leidos" + caso);
     }
+}
 
-    // Cargar clases
-    int numClases;
-    file >> numClases;
-    file.ignore();
+void probarLectorCsv(Verificador& verificar) {
+    const std::string csv =
+        "id,nombre,membresia\r\n"
+        "1,\"Perez, Ana\nMaria\",VIP\r\n"
+        "2,\"Dice \"\"hola\"\"\",Basica\n"
+        "3,Luis,Premium\n"
+        "4,\"sin cerrar,VIP\n";
+    LectorCsv lector(csv.data(), csv.size());
+    std::vector<std::string> campos;
+    std::size_t cantidad;
+    std::uint32_t linea;
+    bool correcta;
+    struct Fila {
+        std::uint32_t linea;
+        bool correcta;
+        std::vector<std::string> campos;
+    };
+    std::vector<Fila> filas;
+    while (lector.siguienteFila(campos, cantidad, linea, correcta)) {
+        filas.push_back({linea, correcta, std::vector<std::string>(campos.begin(),
+                                                                   campos.begin() + cantidad)});
+    }
+    verificar(filas.size() == 5, "cantidad de filas");
+    if (filas.size() != 5) return;
+    verificar(filas[0].campos == std::vector<std::string>{"id", "nombre", "membresia"},
+              "cabecera con CRLF");
+    verificar(filas[1].linea == 2 && filas[1].correcta &&
+                  filas[1].campos == std::vector<std::string>{"1", "Perez, Ana\nMaria", "VIP"},
+              "campo entre comillas con coma y salto de linea");
+    verificar(filas[2].linea == 4 &&
+                  filas[2].campos == std::vector<std::string>{"2", "Dice \"hola\"", "Basica"},
+              "comillas escapadas y numero de linea tras un salto dentro de un campo");
+    verificar(filas[3].linea == 5 && filas[3].campos.size() == 3, "fila simple");
+    verificar(filas[4].linea == 6 && !filas[4].correcta, "comilla sin cerrar");
+}
 
-    for (int i = 0; i < numClases; i++) {
-        std::string linea;
-        std::getline(file, linea);
-        std::stringstream ss(linea);
-        
-        std::string nombre, instructor, horario, codigo;
-        int capacidad;
-        char delimiter;
+void probarJournal(Verificador& verificar, const std::string& dir) {
+    // Lo que se anota en el journal se reproduce igual en un gimnasio nuevo, y
+    // un checkpoint (que recorta el journal) no pierde nada, listas de espera
+    // incluidas
+    const std::string journal = dir + "/prueba.journal";
+    const std::string journalCopia = dir + "/copia.journal";
+    const std::string snapshot = dir + "/prueba.snap";
+    const std::string volcado = dir + "/volcado.txt";
+    const std::int64_t momento = 1700000000;
+    std::string esperado;
+    {
+        Gimnasio original("original");
+        original.activarJournal(journal, ConfigJournal());
+        original.ejecutarRegistroMiembro("Ana", 1, TipoMembresia::VIP);
+        original.ejecutarRegistroMiembro("Bo", 2, TipoMembresia::Basica);
+        original.ejecutarRegistroMiembro("Cy", 3, TipoMembresia::Premium);
+        original.ejecutarCreacionClase("Yoga", "Pat", "Lun 08:00-09:00", "C1", 1);
+        original.ejecutarCreacionClase("Box", "Lu", "Mar 18:00-19:00", "C2", 5);
+        original.ejecutarAsistencia(1, momento);
+        const int lote[] = {1, 2, 2, 9};
+        CodigoResultado resultados[4];
+        original.ejecutarAsistenciasLote(lote, 4, resultados, momento + 3600);
+        original.ejecutarInscripcion(1, "C1");
+        original.ejecutarInscripcion(2, "C1");  // queda en espera
+        original.ejecutarInscripcion(3, "C1");  // queda en espera
+        original.ejecutarInscripcion(3, "C2");
+        original.ejecutarCambioEstado(2, false);
+        original.ejecutarCambioEstado(2, true);
+        original.confirmarCambios();
+        esperado = volcarEstado(original, volcado);
 
-        std::getline(ss, nombre, '|');
-        std::getline(ss, instructor, '|');
-        std::getline(ss, horario, '|');
-        std::getline(ss, codigo, '|');
-        ss >> capacidad;
+        // Reproducir una copia del journal en un gimnasio vacio
+        const std::string copia = leerArchivo(journal);
+        escribirArchivoAtomico(journalCopia, copia.data(), copia.size());
+        Gimnasio reproducido("reproducido");
+        reproducido.activarJournal(journalCopia, ConfigJournal());
+        verificar(!esperado.empty() && volcarEstado(reproducido, volcado) == esperado,
+                  "el journal reproducido no da el mismo estado");
 
-        clases.emplace_back(nombre, instructor, horario, codigo, capacidad);
+        original.checkpoint(snapshot, false);
+        verificar(::access(Journal::rutaAnterior(journal).c_str(), F_OK) != 0,
+                  "el checkpoint no borro el segmento anterior del journal");
+        original.ejecutarCancelacion(1, "C1");  // entra Cy (Premium) antes que Bo
+        original.confirmarCambios();
+        esperado = volcarEstado(original, volcado);
     }
+    Gimnasio recuperado("recuperado");
+    recuperado.cargarSnapshot(snapshot);
+    recuperado.activarJournal(journal, ConfigJournal());
+    verificar(volcarEstado(recuperado, volcado) == esperado,
+              "snapshot + journal no reproducen el mismo estado");
+    verificar(esperado.find("C1,Yoga,Pat,Lun 08:00-09:00,1,1,1") != std::string::npos,
+              "Cy promovida y Bo todavia en espera");
+    std::size_t asistencias = 0;
+    recuperado.contarAsistenciasMiembro(2, momento, momento + 7200, asistencias);
+    verificar(asistencias == 2, "asistencias del lote reproducidas");
+}
 
-    file.close();
-    std::cout << "✅ Datos cargados: " << miembros.size() << " miembros, " 
-              << clases.size() << " clases\n";
+}  // namespace
+
+int ejecutarPruebas() {
+    char plantilla[] = "/tmp/gimnasio_pruebasXXXXXX";
+    const char* dir = ::mkdtemp(plantilla);
+    if (dir == nullptr) {
+        std::cout << "ERROR: No se pudo crear un directorio temporal para las pruebas.\n";
+        return 1;
+    }
+    const std::pair<const char*, std::function<void(Verificador&)>> pruebas[] = {
+        {"ConjuntoIds (borrado con corrimiento)", probarConjuntoIds},
+        {"SerieTemporal (varints y bloques)", probarSerieTemporal},
+        {"parsearHorario (fusion de intervalos)", probarParsearHorario},
+        {"Texto en trozos (numeracion de lineas)", probarTrozosTexto},
+        {"LectorCsv (RFC 4180)", probarLectorCsv},
+        {"Journal (reproduccion y checkpoint)",
+         [&](Verificador& v) { probarJournal(v, dir); }},
+    };
+    int fallidas = 0;
+    for (const auto& prueba : pruebas) {
+        Verificador verificar;
+        {
+            SilenciarSalida silencio;
+            prueba.second(verificar);
+        }
+        if (verificar.fallas.empty()) {
+            std::cout << "✅ " << prueba.first << "\n";
+            continue;
+        }
+        fallidas++;
+        std::cout << "ERROR: " << prueba.first << "\n";
+        for (const std::string& falla : verificar.fallas) std::cout << "   - " << falla << "\n";
+    }
+    for (const char* archivo : {"prueba.journal", "prueba.journal.anterior", "copia.journal",
+                                "prueba.snap", "volcado.txt"}) {
+        ::unlink((std::string(dir) + "/" + archivo).c_str());
+    }
+    ::rmdir(dir);
+    std::cout << (fallidas == 0 ? "INFO: Todas las pruebas pasaron.\n"
+                                : "ERROR: " + std::to_string(fallidas) + " prueba(s) fallaron.\n");
+    return fallidas == 0 ? 0 : 1;
 }
 
 // =================================================================================
@@ -541,6 +7044,13 @@ void mostrarMenu() {
     std::cout << " 9. Mostrar Clases\n";
     std::cout << "10. Resumen Diario\n";
     std::cout << "11. Guardar Datos\n";
+    std::cout << "12. Reporte Analitico\n";
+    std::cout << "13. Historial de Asistencias\n";
+    std::cout << "14. Clases por Horario\n";
+    std::cout << "15. Listado / Exportacion (CSV, JSON)\n";
+    std::cout << "16. Estadisticas de Operaciones\n";
+    std::cout << "17. Buscar Miembro por Nombre\n";
+    std::cout << "18. Clases por Instructor\n";
     std::cout << " 0. Salir\n";
     std::cout << "────────────────────────────────────\n";
     std::cout << "Seleccione una opcion: ";
@@ -551,11 +7061,332 @@ void limpiarBuffer() {
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
-int main() {
+void mostrarMenuFederacion() {
+    std::cout << "\n╔════════════════════════════════════╗\n";
+    std::cout << "║     FEDERACION DE SEDES (CADENA)   ║\n";
+    std::cout << "╚════════════════════════════════════╝\n";
+    std::cout << " 1. Registrar Miembro en una Sede\n";
+    std::cout << " 2. Registrar Asistencia (cualquier sede)\n";
+    std::cout << " 3. Buscar Sede de un Miembro\n";
+    std::cout << " 4. Resumen de la Cadena\n";
+    std::cout << " 5. Guardar Todas las Sedes\n";
+    std::cout << " 0. Salir\n";
+    std::cout << "────────────────────────────────────\n";
+    std::cout << "Seleccione una opcion: ";
+}
+
+// Lista las sedes y lee el numero elegido; -1 si no es valido
+int leerSede(const Federacion& federacion) {
+    for (std::size_t s = 0; s < federacion.numSedes(); s++) {
+        std::cout << "  " << (s + 1) << ". " << federacion.nombreSede(s) << "\n";
+    }
+    std::cout << "Sede (numero): ";
+    int sede;
+    std::cin >> sede;
+    if (std::cin.fail()) sede = 0;
+    limpiarBuffer();
+    if (sede < 1 || sede > static_cast<int>(federacion.numSedes())) {
+        std::cout << "ERROR: Sede invalida.\n";
+        return -1;
+    }
+    return sede - 1;
+}
+
+int menuFederacion(const std::string& archivoSedes) {
+    std::vector<ConfigSede> config;
+    if (!leerConfigSedes(archivoSedes, config)) return 1;
+    Federacion federacion(config);
+    federacion.cargar();
+
+    int opcion;
+    do {
+        mostrarMenuFederacion();
+        std::cin >> opcion;
+        if (std::cin.fail()) {
+            limpiarBuffer();
+            std::cout << "\n❌ Opcion invalida. Intente de nuevo.\n";
+            continue;
+        }
+        limpiarBuffer();
+
+        switch (opcion) {
+            case 1: { // Registrar Miembro en una Sede
+                std::string nombre, tipo;
+                int id;
+                TipoMembresia tipoMembresia;
+                std::cout << "\n--- REGISTRAR MIEMBRO ---\n";
+                int sede = leerSede(federacion);
+                if (sede < 0) break;
+                std::cout << "Nombre completo: ";
+                std::getline(std::cin, nombre);
+                std::cout << "ID (numero): ";
+                std::cin >> id;
+                limpiarBuffer();
+                std::cout << "Tipo (Basica/Premium/VIP): ";
+                std::getline(std::cin, tipo);
+                if (!parsearTipoMembresia(tipo, tipoMembresia)) {
+                    std::cout << "ERROR: Tipo de membresia invalido.\n";
+                    break;
+                }
+                CodigoResultado r = federacion.registrarMiembro(sede, nombre, id, tipoMembresia);
+                if (r == CodigoResultado::Ok) {
+                    std::cout << "EXITO: Miembro " << nombre << " registrado en '"
+                              << federacion.nombreSede(sede) << "'.\n";
+                } else if (r == CodigoResultado::IdDuplicado) {
+                    std::cout << "ERROR: El ID " << id << " ya existe en la sede '"
+                              << federacion.nombreSede(federacion.sedeDeOrigen(id)) << "'.\n";
+                } else {
+                    std::cout << "ERROR: " << nombreResultado(r) << "\n";
+                }
+                break;
+            }
+
+            case 2: { // Registrar Asistencia
+                int id;
+                std::cout << "\n--- REGISTRAR ASISTENCIA ---\n";
+                int sede = leerSede(federacion);
+                if (sede < 0) break;
+                std::cout << "ID del miembro: ";
+                std::cin >> id;
+                limpiarBuffer();
+                CodigoResultado r = federacion.registrarAsistencia(sede, id);
+                if (r == CodigoResultado::Ok) {
+                    int origen = federacion.sedeDeOrigen(id);
+                    std::cout << "EXITO: Asistencia registrada para el ID " << id;
+                    if (origen != sede) {
+                        std::cout << " (miembro de '" << federacion.nombreSede(origen) << "')";
+                    }
+                    std::cout << ".\n";
+                } else if (r == CodigoResultado::MiembroNoEncontrado) {
+                    std::cout << "ERROR: Miembro no encontrado en ninguna sede.\n";
+                } else if (r == CodigoResultado::MembresiaInactiva) {
+                    std::cout << "ERROR: La membresia del miembro esta inactiva.\n";
+                } else {
+                    std::cout << "ERROR: " << nombreResultado(r) << "\n";
+                }
+                break;
+            }
+
+            case 3: { // Buscar Sede de un Miembro
+                int id;
+                std::cout << "\nID del miembro: ";
+                std::cin >> id;
+                limpiarBuffer();
+                int origen = federacion.sedeDeOrigen(id);
+                if (origen < 0) {
+                    std::cout << "ERROR: Miembro no encontrado en ninguna sede.\n";
+                    break;
+                }
+                std::cout << "INFO: Sede de origen: " << federacion.nombreSede(origen) << "\n";
+                federacion.getGimnasio(origen).mostrarHistorialAsistencias(id);
+                break;
+            }
+
+            case 4: { // Resumen de la Cadena
+                federacion.mostrarResumenCadena();
+                break;
+            }
+
+            case 5: { // Guardar Todas las Sedes
+                std::size_t guardadas = federacion.checkpoint();
+                std::cout << "INFO: " << guardadas << "/" << federacion.numSedes()
+                          << " sedes guardadas.\n";
+                break;
+            }
+
+            case 0: { // Salir
+                std::cout << "\n¿Desea guardar los datos antes de salir? (s/n): ";
+                char respuesta;
+                std::cin >> respuesta;
+                if (respuesta == 's' || respuesta == 'S') {
+                    federacion.checkpoint();
+                }
+                std::cout << "\n*** Gracias por usar el Sistema de FitPro Gym ***\n";
+                break;
+            }
+
+            default:
+                std::cout << "\n❌ Opcion invalida. Intente de nuevo.\n";
+        }
+
+        federacion.confirmarCambios();
+    } while (opcion != 0);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--pruebas") {
+        return ejecutarPruebas();
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        ConfigBenchmark config;
+        if (!parsearConfigBenchmark(argc, argv, config)) {
+            std::cout << "Uso: " << argv[0] << " --benchmark [--miembros N] [--clases N]"
+                      << " [--ops N] [--capacidad N] [--mezcla B,P,V] [--sesgo S]"
+                      << " [--semilla N] [--repeticiones N]\n";
+            return 1;
+        }
+        Benchmark benchmark(config);
+        benchmark.ejecutar();
+        benchmark.mostrarReporte();
+        return 0;
+    }
+
+    // Generador de carga contra un "--servidor" ya en marcha
+    if (argc > 1 && std::string(argv[1]) == "--cliente-carga") {
+        ConfigClienteCarga config;
+        if (!parsearConfigClienteCarga(argc, argv, config)) {
+            std::cout << "Uso: " << argv[0] << " --cliente-carga <puerto|ruta.sock>"
+                      << " [--conexiones N] [--peticiones N] [--profundidad N]"
+                      << " [--miembros N] [--clase C] [--semilla N]\n";
+            return 1;
+        }
+        return ejecutarClienteCarga(config);
+    }
+
+    // Varias sedes: "--federacion sedes.txt" con una linea "nombre|rutaBase" por sede
+    if (argc > 1 && std::string(argv[1]) == "--federacion") {
+        if (argc != 3) {
+            std::cout << "Uso: " << argv[0] << " --federacion <archivo de sedes>\n";
+            return 1;
+        }
+        return menuFederacion(argv[2]);
+    }
+
+    // Modo exportacion: stdout queda solo para los datos; los avisos de carga van a stderr
+    const bool modoExportar = argc > 1 && std::string(argv[1]) == "--exportar";
+    ConfigExportacion configExportacion;
+    if (modoExportar && !parsearConfigExportacion(argc, argv, configExportacion)) {
+        std::cout << "Uso: " << argv[0] << " --exportar <miembros|clases>"
+                  << " [--formato texto|csv|json] [--membresia T] [--activos 0|1]"
+                  << " [--min-asistencias N] [--instructor X] [--con-cupo] [--desde C]"
+                  << " [--limite N] [--salida archivo]\n";
+        return 1;
+    }
+    // Los argumentos se validan antes de cargar los datos y reproducir el journal
+    if (argc > 1 && std::string(argv[1]) == "--lote" && argc != 3) {
+        std::cout << "Uso: " << argv[0] << " --lote <archivo|->\n";
+        return 1;
+    }
+    std::streambuf* salidaOriginal = std::cout.rdbuf();
+    if (modoExportar) std::cout.rdbuf(std::cerr.rdbuf());
+
     Gimnasio fitPro("FitPro Gym & Wellness");
     
-    // Intentar cargar datos previos
-    fitPro.cargarDatos("gimnasio_datos.txt");
+    // Intentar cargar datos previos (snapshot binario; si no existe, texto legado)
+    if (!fitPro.cargarSnapshot("gimnasio_datos.snap")) {
+        fitPro.cargarDatos("gimnasio_datos.txt");
+    }
+
+    if (modoExportar) {
+        fitPro.activarJournal("gimnasio_datos.journal");
+        std::cout.rdbuf(salidaOriginal);
+        SalidaBuffer salida;
+        if (!configExportacion.salida.empty() && !salida.abrir(configExportacion.salida)) {
+            std::cerr << "ERROR: No se pudo crear " << configExportacion.salida << "\n";
+            return 1;
+        }
+        const ConfigExportacion& c = configExportacion;
+        Handle siguiente = c.clases
+            ? fitPro.exportarClases(salida, c.filtroClases, c.formato, c.cursor, c.limite)
+            : fitPro.exportarMiembros(salida, c.filtroMiembros, c.formato, c.cursor, c.limite);
+        salida.vaciar();
+        if (siguiente != HANDLE_INVALIDO) {
+            std::cerr << "INFO: Hay mas registros; continuar con --desde " << siguiente << "\n";
+        }
+        return salida.ok() ? 0 : 1;
+    }
+
+    // Modo sin menu: aplica un archivo de comandos (o stdin con "-") y resume al final
+    if (argc > 1 && std::string(argv[1]) == "--lote") {
+        // Lotes de journal mas grandes: al final del lote se confirma todo igual
+        ConfigJournal configLote;
+        configLote.registrosPorLote = 4096;
+        configLote.lotesPorFsync = 16;
+        fitPro.activarJournal("gimnasio_datos.journal", configLote);
+        std::string entrada;
+        std::unique_ptr<ArchivoMapeado> mapa;
+        const char* datos = nullptr;
+        std::size_t largo = 0;
+        if (std::string(argv[2]) == "-") {
+            entrada.assign(std::istreambuf_iterator<char>(std::cin),
+                           std::istreambuf_iterator<char>());
+            datos = entrada.data();
+            largo = entrada.size();
+        } else {
+            mapa = std::make_unique<ArchivoMapeado>(argv[2]);
+            if (!mapa->valido()) {
+                std::cout << "ERROR: No se pudo leer " << argv[2] << "\n";
+                return 1;
+            }
+            datos = mapa->data();
+            largo = mapa->size();
+        }
+
+        auto inicio = std::chrono::steady_clock::now();
+        ProcesadorComandos procesador(fitPro, "gimnasio_datos.snap");
+        procesador.procesar(datos, largo);
+        procesador.mostrarResumen(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - inicio).count());
+        fitPro.getMetricas().mostrar();
+        const std::string json = fitPro.getMetricas().aJson();
+        escribirArchivoAtomico("gimnasio_metricas.json", json.data(), json.size());
+        return 0;
+    }
+
+    // Alta masiva: "--importar miembros.csv"; al final deja un snapshot con todo
+    if (argc > 1 && std::string(argv[1]) == "--importar") {
+        if (argc != 3) {
+            std::cout << "Uso: " << argv[0] << " --importar <miembros.csv>\n";
+            return 1;
+        }
+        ArchivoMapeado mapa(argv[2]);
+        if (!mapa.valido()) {
+            std::cout << "ERROR: No se pudo leer " << argv[2] << "\n";
+            return 1;
+        }
+        ConfigJournal configLote;
+        configLote.registrosPorLote = 4096;
+        configLote.lotesPorFsync = 16;
+        fitPro.activarJournal("gimnasio_datos.journal", configLote);
+        ResultadoImportacion resultado = fitPro.importarMiembros(mapa.data(), mapa.size());
+        resultado.mostrar();
+        if (resultado.importados > 0) fitPro.checkpoint("gimnasio_datos.snap");
+        return resultado.cabeceraValida ? 0 : 1;
+    }
+
+    // Servicio local: "--servidor <puerto|ruta.sock>"; Ctrl+C lo detiene con checkpoint
+    if (argc > 1 && std::string(argv[1]) == "--servidor") {
+        if (argc != 3) {
+            std::cout << "Uso: " << argv[0] << " --servidor <puerto|ruta.sock>\n";
+            return 1;
+        }
+        ServidorGimnasio servidor(fitPro, argv[2]);
+        if (!servidor.iniciar()) {  // antes de crear hilos: heredan la mascara de senales
+            std::cout << "ERROR: No se pudo escuchar en " << argv[2] << "\n";
+            return 1;
+        }
+        // El bucle confirma el journal una vez por despertar (group commit)
+        ConfigJournal configServidor;
+        configServidor.registrosPorLote = 4096;
+        configServidor.lotesPorFsync = 16;
+        fitPro.activarJournal("gimnasio_datos.journal", configServidor);
+        Autoguardado autoguardado(fitPro, "gimnasio_datos.snap");
+        VolcadoMetricas volcado(fitPro.getMetricas(), "gimnasio_metricas.json",
+                                std::chrono::seconds(30));
+        servidor.ejecutar();
+        servidor.mostrarResumen();
+        fitPro.checkpoint("gimnasio_datos.snap");
+        return 0;
+    }
+
+    fitPro.activarJournal("gimnasio_datos.journal");
+    // Guardados sin congelar el menu: por tiempo/cambios y bajo pedido (opcion 11)
+    Autoguardado autoguardado(fitPro, "gimnasio_datos.snap");
+    // Metricas legibles por maquina para monitoreo externo
+    VolcadoMetricas volcado(fitPro.getMetricas(), "gimnasio_metricas.json",
+                            std::chrono::seconds(30));
     
     int opcion;
     
@@ -689,7 +7520,128 @@ int main() {
             }
             
             case 11: { // Guardar Datos
-                fitPro.guardarDatos("gimnasio_datos.txt");
+                autoguardado.solicitar();
+                std::cout << "INFO: Guardando en segundo plano; puede seguir trabajando.\n";
+                break;
+            }
+            
+            case 12: { // Reporte Analitico
+                fitPro.mostrarReporteAnalitico();
+                break;
+            }
+
+            case 13: { // Historial de Asistencias
+                int id;
+                std::cout << "\n--- HISTORIAL DE ASISTENCIAS ---\n";
+                std::cout << "ID del miembro: ";
+                std::cin >> id;
+                limpiarBuffer();
+
+                fitPro.mostrarHistorialAsistencias(id);
+                break;
+            }
+
+            case 14: { // Clases por Horario
+                std::string consulta;
+                std::cout << "\n--- CLASES POR HORARIO ---\n";
+                std::cout << "Dia y rango (ej: Lun 18:00-19:00): ";
+                std::getline(std::cin, consulta);
+
+                fitPro.mostrarClasesEnHorario(consulta);
+                break;
+            }
+
+            case 15: { // Listado / Exportacion
+                std::string entidad, formato, valor, archivo;
+                std::size_t porPagina = 0;
+                FiltroMiembros filtroMiembros;
+                FiltroClases filtroClases;
+
+                std::cout << "\n--- LISTADO / EXPORTACION ---\n";
+                std::cout << "Listar (miembros/clases): ";
+                std::getline(std::cin, entidad);
+                const bool listarClases = entidad == "clases";
+                if (listarClases) {
+                    std::cout << "Instructor (vacio = todos): ";
+                    std::getline(std::cin, filtroClases.instructor);
+                    std::cout << "Solo con cupo (s/n): ";
+                    std::getline(std::cin, valor);
+                    filtroClases.soloConCupo = valor == "s" || valor == "S";
+                } else {
+                    TipoMembresia tipo;
+                    std::cout << "Membresia (Basica/Premium/VIP, vacio = todas): ";
+                    std::getline(std::cin, valor);
+                    if (parsearTipoMembresia(valor, tipo)) {
+                        filtroMiembros.tipoMembresia = static_cast<int>(tipo);
+                    }
+                    std::cout << "Estado (activos/inactivos, vacio = todos): ";
+                    std::getline(std::cin, valor);
+                    if (valor == "activos") filtroMiembros.activo = 1;
+                    if (valor == "inactivos") filtroMiembros.activo = 0;
+                    std::cout << "Asistencias minimas: ";
+                    std::getline(std::cin, valor);
+                    filtroMiembros.minAsistencias = std::atoi(valor.c_str());
+                }
+                std::cout << "Formato (texto/csv/json): ";
+                std::getline(std::cin, formato);
+                FormatoExportacion f = formato == "csv"    ? FormatoExportacion::Csv
+                                       : formato == "json" ? FormatoExportacion::Json
+                                                           : FormatoExportacion::Texto;
+                std::cout << "Archivo de salida (vacio = pantalla): ";
+                std::getline(std::cin, archivo);
+                if (archivo.empty()) {
+                    std::cout << "Registros por pagina (0 = todos): ";
+                    std::getline(std::cin, valor);
+                    porPagina = static_cast<std::size_t>(std::max(std::atoi(valor.c_str()), 0));
+                }
+
+                SalidaBuffer salida;
+                if (!archivo.empty() && !salida.abrir(archivo)) {
+                    std::cout << "ERROR: No se pudo crear el archivo " << archivo << "\n";
+                    break;
+                }
+                std::size_t limite = porPagina > 0 ? porPagina
+                                                   : std::numeric_limits<std::size_t>::max();
+                Handle cursor = 0;
+                while (true) {
+                    cursor = listarClases
+                        ? fitPro.exportarClases(salida, filtroClases, f, cursor, limite)
+                        : fitPro.exportarMiembros(salida, filtroMiembros, f, cursor, limite);
+                    salida.vaciar();
+                    if (cursor == HANDLE_INVALIDO) break;
+                    std::cout << "-- Enter: siguiente pagina | q: terminar -- ";
+                    std::getline(std::cin, valor);
+                    if (valor == "q" || valor == "Q") break;
+                }
+                if (!archivo.empty()) {
+                    std::cout << (salida.ok() ? "\n✅ Listado exportado a '" : "ERROR: Fallo la escritura de '")
+                              << archivo << "'\n";
+                }
+                break;
+            }
+            
+            case 16: { // Estadisticas de Operaciones
+                fitPro.getMetricas().mostrar();
+                break;
+            }
+
+            case 17: { // Buscar Miembro por Nombre
+                std::string prefijo;
+                std::cout << "\n--- BUSCAR MIEMBRO ---\n";
+                std::cout << "Inicio del nombre o apellido: ";
+                std::getline(std::cin, prefijo);
+
+                fitPro.mostrarBusquedaMiembros(prefijo);
+                break;
+            }
+
+            case 18: { // Clases por Instructor
+                std::string instructor;
+                std::cout << "\n--- CLASES POR INSTRUCTOR ---\n";
+                std::cout << "Instructor: ";
+                std::getline(std::cin, instructor);
+
+                fitPro.mostrarClasesDeInstructor(instructor);
                 break;
             }
             
@@ -698,7 +7650,7 @@ int main() {
                 char respuesta;
                 std::cin >> respuesta;
                 if (respuesta == 's' || respuesta == 'S') {
-                    fitPro.guardarDatos("gimnasio_datos.txt");
+                    fitPro.checkpoint("gimnasio_datos.snap");
                 }
                 std::cout << "\n*** Gracias por usar el Sistema de FitPro Gym ***\n";
                 break;
@@ -708,6 +7660,8 @@ int main() {
                 std::cout << "\n❌ Opcion invalida. Intente de nuevo.\n";
         }
         
+        // Group commit: lo hecho en esta opcion llega al journal antes de seguir
+        fitPro.confirmarCambios();
     } while(opcion != 0);
     
     return 0;
@@ -722,5 +7676,30 @@ int main() {
 // ✅ Manejo robusto de errores de entrada
 // ✅ Estructura modular simulando archivos separados
 // ✅ Funcionalidades esenciales sin sobrecarga
+// ✅ Registro indexado (hash id/codigo -> slot) con handles estables
+// ✅ Snapshot binario versionado con tabla de cadenas, cargado via mmap
+// ✅ Journal de escritura anticipada con group commit y fsync por lotes
+// ✅ Registro de asistencias por lote (torniquetes) sin salida por consola
+// ✅ Roster de clase en conjunto hash abierto: inscribir/cancelar/consultar O(1)
+// ✅ Tipos de membresia como enum con tabla constexpr de politicas
+// ✅ Getters por referencia y codigos de clase internados como IdClase
+// ✅ Motor seguro entre hilos: shards de miembros y franjas de clases con mutex
+// ✅ Benchmark con poblacion sintetica (--benchmark): ops/seg, p50 y p99
+// ✅ Modo por lotes (--lote archivo|-) con parser sin asignaciones por campo
+// ✅ Vista columnar de miembros con kernels de agregacion vectorizables
+// ✅ Resumen diario O(1): cupos incrementales y asistencias por dia con rotacion
+// ✅ Historial de asistencias con marcas de tiempo en bloques delta/varint y conteo por hora
+// ✅ Listas de espera por clase con prioridad por membresia y promocion automatica
+// ✅ Horarios semanales estructurados: linea de tiempo por hora y choques por miembro
+// ✅ Inscripciones persistidas como grafo CSR (ambos sentidos) en snapshot y texto
+// ✅ Listados con filtros, cursor de paginacion y salida CSV/JSON por buffer grande
+// ✅ Indice de registros sobre arena monotona y conteo de asignaciones en cada carga
+// ✅ Federacion de sedes (--federacion): hilo por sede, directorio global y resumen de cadena
+// ✅ Snapshots capturados en memoria y escritos fuera del bloqueo (tmp + rename), autoguardado
+// ✅ Histogramas de latencia por operacion y rechazos por motivo (opcion 16 y volcado JSON)
+// ✅ Carga de texto en paralelo por trozos (mmap + from_chars) con lineas malformadas numeradas
+// ✅ Importacion masiva de miembros desde CSV (--importar) con deduplicacion y reporte por fila
+// ✅ Indices secundarios: prefijo de nombre sin acentos (opcion 17) e instructor -> clases (18)
+// ✅ Servicio local por socket con bucle epoll y pipelining (--servidor) y cliente de carga
 // =================================================================================
 